@@ -0,0 +1,134 @@
+#ifndef LMP_PROJECT_HARDWARE_IMU_BATCH_H_
+#define LMP_PROJECT_HARDWARE_IMU_BATCH_H_
+
+#include "imu/common.h"
+#include "imu/fifo_monitor.h"
+
+/**
+ * @file batch.h
+ * @brief Callback delivery of FIFO sample batches without copying into caller structs
+ *
+ * The FIFO must be enabled with enable_fifo(FIFO_EN_ACCEL | FIFO_EN_GYRO).
+ * Each poll drains the FIFO into a free internal buffer, decodes it once and
+ * hands the callback a read-only view into that buffer. The buffer is not
+ * reused until the view is released with imu_batch_release(), which may be
+ * called from inside the callback or later. Poll and release must be called
+ * from the same thread (or be synchronized by the caller).
+ *
+ * Losses are reported twice: the poll that detects them returns
+ * RC_SAMPLES_LOST, and the next view carries lost / overflow so a gap is
+ * visible in the stream (first_sample jumps by lost). Without a fifo_monitor_t
+ * only a misaligned / full FIFO is detected and lost counts the discarded
+ * frames.
+ *
+ * A sample rate change by the adaptive controller is flagged with
+ * rate_changed on the first view at the new rate; sample spacing derived from
+ * views taken before the change (e.g. a vib_analyzer_t sample_rate_hz) no
+ * longer applies.
+*/
+
+#define IMU_BATCH_BUFFERS_MAX 8
+#define IMU_BATCH_FRAMES_MAX  (FIFO_SIZE / FIFO_FRAME_ACCEL_GYRO)
+
+#ifdef __cplusplus
+extern "C" {
+#endif //__cplusplus
+
+typedef struct {
+    const vec3i_t* accel_raw;   // count raw accel samples
+    const vec3i_t* gyro_raw;    // count raw gyro samples
+    const vec3f_t* accel;       // count accel samples [g]
+    const vec3f_t* gyro;        // count gyro samples [deg / s]
+    unsigned int count;         // number of samples
+    uint32_t seq;               // batch sequence number
+    uint64_t first_sample;      // index of the first sample, including lost samples
+    unsigned int lost;          // samples lost right before this batch (estimated on overflow)
+    bool overflow;              // a FIFO overflow occurred right before this batch
+    float rate_hz;              // sample rate of this batch, 0 without a fifo_monitor_t
+    bool rate_changed;          // rate_hz differs from the previous batch
+    unsigned int slot;          // internal buffer index, used by imu_batch_release()
+} imu_batch_view_t;
+
+/**
+ * @brief Batch callback
+ *
+ * @param view View into the internal buffer, valid until imu_batch_release(view)
+ * @param user User pointer passed to imu_batch_consumer_init()
+*/
+typedef void (*imu_batch_cb_t)(const imu_batch_view_t* view, void* user);
+
+typedef struct {
+    uint8_t* fifo;              // FIFO_SIZE bytes as read from FIFO_R_W
+    vec3i_t* accel_raw;
+    vec3i_t* gyro_raw;
+    vec3f_t* accel;
+    vec3f_t* gyro;
+    imu_batch_view_t view;
+    bool in_use;
+} imu_batch_slot_t;
+
+typedef struct {
+    imu_batch_cb_t cb;
+    void* user;
+    float accel_per_digit;
+    float gyro_per_digit;
+    unsigned int n_slots;
+    unsigned int next;          // next slot to try
+    uint32_t seq;
+    uint64_t next_sample;       // index of the next sample to deliver
+    unsigned int pending_lost;  // lost samples not yet reported in a view
+    bool pending_overflow;
+    float fifo_rate_hz;         // rate of the samples currently in the FIFO
+    float last_rate_hz;         // rate of the last delivered batch
+    void* block;                // single allocation backing all slots
+    imu_batch_slot_t slots[IMU_BATCH_BUFFERS_MAX];
+} imu_batch_consumer_t;
+
+/**
+ * @brief Allocate the internal buffers of a consumer
+ *
+ * @param[out] c Consumer to initialize
+ * @param n_buffers Number of batches that can be held at once (1 - IMU_BATCH_BUFFERS_MAX)
+ * @param accel_per_digit Accel conversion factor (ACCEL_PER_DIGIT_*)
+ * @param gyro_per_digit Gyro conversion factor (GYRO_PER_DIGIT_*)
+ * @param cb Callback invoked for each batch
+ * @param user User pointer passed to cb
+ * @return RC_OK if OK, otherwise RC_INVALID_ARGUMENT, RC_RESOURCE_UNAVAILABLE
+*/
+int imu_batch_consumer_init(imu_batch_consumer_t* c, unsigned int n_buffers, float accel_per_digit, float gyro_per_digit, imu_batch_cb_t cb, void* user);
+
+/**
+ * @brief Release the internal buffers of a consumer
+ *
+ * Views that were not released become invalid.
+ *
+ * @param c Consumer
+*/
+void imu_batch_consumer_free(imu_batch_consumer_t* c);
+
+/**
+ * @brief Drain the FIFO into a free buffer and invoke the callback
+ *
+ * @param pi Pigpio handle (returned by pigpiod_daemon_open)
+ * @param handle I2C session handle (returned by i2c_begin_session)
+ * @param c Consumer
+ * @param mon FIFO monitor for overflow detection / rate control, NULL to skip
+ * @return Number of samples delivered (>= 0) if OK, otherwise
+ *      RC_SAMPLES_LOST (the FIFO overflowed or lost alignment and was reset, nothing delivered),
+ *      RC_RESOURCE_UNAVAILABLE (all buffers held, the FIFO is left untouched), RC_FAIL_GET, RC_FAIL_SET
+*/
+int imu_batch_poll(int pi, unsigned int handle, imu_batch_consumer_t* c, fifo_monitor_t* mon);
+
+/**
+ * @brief Return a batch buffer to the consumer
+ *
+ * @param c Consumer
+ * @param view View passed to the callback
+*/
+void imu_batch_release(imu_batch_consumer_t* c, const imu_batch_view_t* view);
+
+#ifdef __cplusplus
+}
+#endif //__cplusplus
+
+#endif //LMP_PROJECT_HARDWARE_IMU_BATCH_H_
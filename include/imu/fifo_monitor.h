@@ -0,0 +1,102 @@
+#ifndef LMP_PROJECT_HARDWARE_IMU_FIFO_MONITOR_H_
+#define LMP_PROJECT_HARDWARE_IMU_FIFO_MONITOR_H_
+
+#include "imu/common.h"
+
+/**
+ * @file fifo_monitor.h
+ * @brief FIFO overflow / sample loss detection and optional adaptive sample rate control
+ *
+ * The MPU-6050 has no sample counter, so the number of lost samples is
+ * estimated from the host clock and the configured sample rate.
+ * Call fifo_monitor_poll() before each FIFO read and fifo_monitor_consumed()
+ * after it.
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif //__cplusplus
+
+typedef struct {
+    uint8_t div_min;            // highest rate the controller may select
+    uint8_t div_max;            // lowest rate the controller may select
+    float high_watermark;       // FIFO fill fraction (0 - 1) above which the rate is lowered
+    float low_watermark;        // FIFO fill fraction (0 - 1) below which the rate may be raised
+    unsigned int raise_after;   // consecutive polls below low_watermark before raising the rate
+} rate_ctrl_cfg_t;
+
+typedef struct {
+    unsigned int frame_size;    // bytes per FIFO frame
+    unsigned int capacity;      // complete frames the FIFO can hold
+    float base_rate_hz;         // gyro output rate (depends on DLPF)
+    float rate_hz;              // current sample rate
+    uint8_t div;                // current SMPLRT_DIV
+
+    bool adaptive;
+    rate_ctrl_cfg_t ctrl;
+    unsigned int low_streak;
+
+    double last_poll_s;
+    unsigned int backlog;       // frames left in the FIFO since the last poll
+
+    uint64_t samples_read;      // frames reported via fifo_monitor_consumed()
+    uint64_t samples_lost;      // estimated frames lost to overflows and misalignment
+    unsigned int overflow_events;
+    unsigned int misaligned_events; // FIFO count not a multiple of frame_size without an overflow
+    unsigned int rate_changes;
+} fifo_monitor_t;
+
+typedef struct {
+    unsigned int frames;        // complete frames ready to be read
+    bool overflow;              // the FIFO overflowed and was reset
+    bool misaligned;            // the FIFO lost frame alignment without overflow and was reset
+    unsigned int lost;          // frames lost by this poll (estimated on overflow)
+    bool rate_changed;          // the controller changed SMPLRT_DIV
+} fifo_poll_t;
+
+/**
+ * @brief Initialize a monitor for a FIFO already enabled with enable_fifo()
+ *
+ * The current SMPLRT_DIV and DLPF configuration are read from the sensor.
+ * With adaptive control SMPLRT_DIV is clamped into [div_min, div_max].
+ *
+ * @param pi Pigpio handle (returned by pigpiod_daemon_open)
+ * @param handle I2C session handle (returned by i2c_begin_session)
+ * @param[out] mon Monitor to initialize
+ * @param frame_size Bytes per FIFO frame, e.g. FIFO_FRAME_ACCEL_GYRO
+ * @param ctrl Adaptive rate control configuration, NULL for monitoring only
+ * @return RC_OK if OK, otherwise RC_INVALID_ARGUMENT, RC_FAIL_GET, RC_FAIL_SET
+*/
+int fifo_monitor_init(int pi, unsigned int handle, fifo_monitor_t* mon, unsigned int frame_size, const rate_ctrl_cfg_t* ctrl);
+
+/**
+ * @brief Check the FIFO for overflow and the number of frames ready
+ *
+ * On overflow the FIFO is reset, since its frame alignment is lost, and the
+ * estimated loss is added to the monitor. A FIFO count that is not a multiple
+ * of frame_size without an overflow also resets the FIFO; only the discarded
+ * frames are counted as lost and it is not an overflow event.
+ * With adaptive control enabled, SMPLRT_DIV is raised on overflow or above
+ * high_watermark and lowered after raise_after polls below low_watermark.
+ *
+ * @param pi Pigpio handle (returned by pigpiod_daemon_open)
+ * @param handle I2C session handle (returned by i2c_begin_session)
+ * @param mon Monitor
+ * @param[out] dst Pointer to store the poll result
+ * @return RC_OK if OK, otherwise RC_FAIL_GET, RC_FAIL_SET
+*/
+int fifo_monitor_poll(int pi, unsigned int handle, fifo_monitor_t* mon, fifo_poll_t* dst);
+
+/**
+ * @brief Report frames read from the FIFO since the last poll
+ *
+ * @param mon Monitor
+ * @param frames Number of frames read
+*/
+void fifo_monitor_consumed(fifo_monitor_t* mon, unsigned int frames);
+
+#ifdef __cplusplus
+}
+#endif //__cplusplus
+
+#endif //LMP_PROJECT_HARDWARE_IMU_FIFO_MONITOR_H_
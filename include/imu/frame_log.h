@@ -0,0 +1,87 @@
+#ifndef LMP_PROJECT_HARDWARE_IMU_FRAME_LOG_H_
+#define LMP_PROJECT_HARDWARE_IMU_FRAME_LOG_H_
+
+#include "imu/return_code.h"
+#include "imu/mpu6050_config.h"
+#include <stdio.h>
+
+/**
+ * @file frame_log.h
+ * @brief On-disk format of recorded IMU frame files
+ *
+ * A frame file is a frame_log_header_t followed by raw frames of
+ * header.frame_size bytes each, in host byte order. Each frame starts with an
+ * imu_frame_t; any extra bytes (e.g. external sensor data) are appended after it.
+ * Physical values are raw * accel_per_digit / gyro_per_digit.
+ *
+ * Files are written with frame_log_open() / frame_log_append(), e.g. from a
+ * batch callback: frame_log_append(&log, view->accel_raw, view->gyro_raw, view->count).
+*/
+
+#define FRAME_LOG_MAGIC   0x46554D49u /* "IMUF" */
+#define FRAME_LOG_VERSION 1
+
+typedef struct {
+    uint32_t magic;          // FRAME_LOG_MAGIC
+    uint16_t version;        // FRAME_LOG_VERSION
+    uint16_t frame_size;     // bytes per frame, >= sizeof(imu_frame_t)
+    float sample_rate_hz;    // sample rate of the recording
+    float accel_per_digit;   // [g / digit]
+    float gyro_per_digit;    // [deg / s / digit]
+    uint32_t reserved;
+} frame_log_header_t;
+
+typedef struct {
+    vec3i_t accel;
+    vec3i_t gyro;
+} imu_frame_t;
+
+#ifndef __cplusplus
+_Static_assert(sizeof(frame_log_header_t) == 24, "frame_log_header_t must be 24 bytes");
+_Static_assert(sizeof(imu_frame_t) == 12, "imu_frame_t must be 12 bytes");
+#endif //__cplusplus
+
+typedef struct {
+    FILE* fp;
+} frame_log_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif //__cplusplus
+
+/**
+ * @brief Create (truncate) a frame file and write its header
+ *
+ * @param[out] log Log to open
+ * @param path File path
+ * @param sample_rate_hz Sample rate of the recording
+ * @param accel_per_digit Accel conversion factor (ACCEL_PER_DIGIT_*)
+ * @param gyro_per_digit Gyro conversion factor (GYRO_PER_DIGIT_*)
+ * @return RC_OK if OK, otherwise RC_INVALID_ARGUMENT, RC_FAIL_FILE_IO
+*/
+int frame_log_open(frame_log_t* log, const char* path, float sample_rate_hz, float accel_per_digit, float gyro_per_digit);
+
+/**
+ * @brief Append n raw accel / gyro frames
+ *
+ * @param log Open log
+ * @param accel n raw accel samples
+ * @param gyro n raw gyro samples
+ * @param n Number of frames
+ * @return RC_OK if OK, otherwise RC_FAIL_FILE_IO
+*/
+int frame_log_append(frame_log_t* log, const vec3i_t* accel, const vec3i_t* gyro, unsigned int n);
+
+/**
+ * @brief Flush and close the file
+ *
+ * @param log Open log
+ * @return RC_OK if OK, otherwise RC_FAIL_FILE_IO
+*/
+int frame_log_close(frame_log_t* log);
+
+#ifdef __cplusplus
+}
+#endif //__cplusplus
+
+#endif //LMP_PROJECT_HARDWARE_IMU_FRAME_LOG_H_
@@ -153,6 +153,129 @@ int get_sensor_data_real_fast(int pi, unsigned int handle, sensor_data_real_fast
 
 int get_accel_gyro_data_real_fast(int pi, unsigned int handle, sensor_data_real_fast_t* accel, sensor_data_real_fast_t* gyro);
 
+/**
+ * @brief Enable or disable the auxiliary I2C bypass mux
+ *
+ * With bypass enabled the auxiliary bus is connected to the host bus, so an
+ * external sensor (e.g. a magnetometer) can be configured directly by the host.
+ * Enabling bypass also disables the auxiliary I2C master (USER_CTRL.I2C_MST_EN),
+ * which would otherwise keep the mux closed; call enable_aux_i2c_slave0() again
+ * to resume sampling.
+ *
+ * @param pi Pigpio handle (returned by pigpiod_daemon_open)
+ * @param handle I2C session handle (returned by i2c_begin_session)
+ * @param enable true to connect the auxiliary bus to the host bus
+ * @return RC_OK if OK, otherwise RC_FAIL_SET
+*/
+int set_aux_i2c_bypass(int pi, unsigned int handle, bool enable);
+
+/**
+ * @brief Let the auxiliary I2C master sample an external sensor through I2C_SLV0
+ *
+ * The external sensor is read once per sample period and its bytes are stored
+ * in EXT_SENS_DATA_00.. right after the gyro registers.
+ * The external sensor must already be configured (e.g. via set_aux_i2c_bypass).
+ * This disables the bypass mux.
+ *
+ * @param pi Pigpio handle (returned by pigpiod_daemon_open)
+ * @param handle I2C session handle (returned by i2c_begin_session)
+ * @param cfg External sensor address, first register and number of bytes
+ * @return RC_OK if OK, otherwise RC_INVALID_I2C_ADDR, RC_INVALID_ARGUMENT, RC_FAIL_SET
+*/
+int enable_aux_i2c_slave0(int pi, unsigned int handle, const aux_i2c_slave_cfg_t* cfg);
+
+/**
+ * @brief Stop sampling through I2C_SLV0 and disable the auxiliary I2C master
+ *
+ * @param pi Pigpio handle (returned by pigpiod_daemon_open)
+ * @param handle I2C session handle (returned by i2c_begin_session)
+ * @return RC_OK if OK, otherwise RC_FAIL_SET
+*/
+int disable_aux_i2c_master(int pi, unsigned int handle);
+
+/**
+ * @brief Fast read of accel / gyro data in physical units and external sensor data
+ *
+ * Same as get_accel_gyro_data_real_fast(), but the external sensor payload
+ * sampled by the auxiliary I2C master is returned in the same burst read.
+ *
+ * @param pi Pigpio handle (returned by pigpiod_daemon_open)
+ * @param handle I2C session handle (returned by i2c_begin_session)
+ * @param[out] accel Pointer to sensor_data_real_fast_t for accelerometer
+ *      containing sensor type and per_digit factor
+ * @param[out] gyro Pointer to sensor_data_real_fast_t for gyroscope
+ *      containing sensor type and per_digit factor
+ * @param[out] ext Pointer to ext_sens_data_t containing the number of bytes
+ *      configured with enable_aux_i2c_slave0
+ *
+ * @return RC_OK if OK, otherwise RC_INVALID_ARGUMENT, RC_FAIL_GET
+*/
+int get_accel_gyro_ext_data_real_fast(int pi, unsigned int handle, sensor_data_real_fast_t* accel, sensor_data_real_fast_t* gyro, ext_sens_data_t* ext);
+
+/**
+ * @brief Enable the FIFO for the given sources and reset it
+ *
+ * Frames are stored in register order: accel (6), temp (2), gyro (6), SLV0 data.
+ * The FIFO overflow interrupt is enabled as well.
+ *
+ * @param pi Pigpio handle (returned by pigpiod_daemon_open)
+ * @param handle I2C session handle (returned by i2c_begin_session)
+ * @param sources FIFO_EN_* flags, e.g. FIFO_EN_ACCEL | FIFO_EN_GYRO
+ * @return RC_OK if OK, otherwise RC_FAIL_SET
+*/
+int enable_fifo(int pi, unsigned int handle, uint8_t sources);
+
+/**
+ * @brief Disable the FIFO
+ *
+ * @param pi Pigpio handle (returned by pigpiod_daemon_open)
+ * @param handle I2C session handle (returned by i2c_begin_session)
+ * @return RC_OK if OK, otherwise RC_FAIL_SET
+*/
+int disable_fifo(int pi, unsigned int handle);
+
+/**
+ * @brief Discard the FIFO contents
+ *
+ * @param pi Pigpio handle (returned by pigpiod_daemon_open)
+ * @param handle I2C session handle (returned by i2c_begin_session)
+ * @return RC_OK if OK, otherwise RC_FAIL_SET
+*/
+int reset_fifo(int pi, unsigned int handle);
+
+/**
+ * @brief Get the number of bytes stored in the FIFO
+ *
+ * @param pi Pigpio handle (returned by pigpiod_daemon_open)
+ * @param handle I2C session handle (returned by i2c_begin_session)
+ * @param[out] value Pointer to store the byte count (0 - FIFO_SIZE)
+ * @return RC_OK if OK, otherwise RC_FAIL_GET
+*/
+int get_fifo_count(int pi, unsigned int handle, uint16_t* value);
+
+/**
+ * @brief Read INT_STATUS (INT_FIFO_OFLOW, INT_DATA_RDY, ...)
+ *
+ * The interrupt bits are cleared by this read.
+ *
+ * @param pi Pigpio handle (returned by pigpiod_daemon_open)
+ * @param handle I2C session handle (returned by i2c_begin_session)
+ * @param[out] value Pointer to store INT_STATUS
+ * @return RC_OK if OK, otherwise RC_FAIL_GET
+*/
+int get_int_status(int pi, unsigned int handle, uint8_t* value);
+
+/**
+ * @brief Read n bytes from the FIFO
+ *
+ * @param pi Pigpio handle (returned by pigpiod_daemon_open)
+ * @param handle I2C session handle (returned by i2c_begin_session)
+ * @param[out] buf Destination buffer
+ * @param n Number of bytes (1 - FIFO_SIZE), should not exceed get_fifo_count()
+ * @return RC_OK if OK, otherwise RC_FAIL_GET
+*/
+int read_fifo(int pi, unsigned int handle, uint8_t* buf, unsigned int n);
+
 #ifdef __cplusplus
 }
 #endif //__cplusplus
@@ -0,0 +1,252 @@
+#ifndef LMP_PROJECT_HARDWARE_IMU_MPU_6050_HPP_
+#define LMP_PROJECT_HARDWARE_IMU_MPU_6050_HPP_
+
+#include "imu/daemon.h"
+#include "imu/mpu6050.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <utility>
+
+/**
+ * @file mpu6050.hpp
+ * @brief Header-only C++20 RAII layer over the MPU-6050 C API
+ *
+ * Sensor ranges are template parameters, so the per digit conversion factors
+ * are resolved at compile time and cannot drift from the configured range.
+*/
+
+namespace imu {
+
+/**
+ * @brief Exception thrown when a daemon connection or session cannot be set up
+*/
+class error : public std::runtime_error {
+public:
+    error(const char* what, int rc) : std::runtime_error(what), rc_(rc) {}
+
+    /** @return Return code (RC_*) reported by the C API */
+    int code() const noexcept { return rc_; }
+
+private:
+    int rc_;
+};
+
+constexpr float accel_per_digit(accel_range_t range) {
+    switch (range) {
+        case ACCEL_2_G:  return ACCEL_PER_DIGIT_2_G;
+        case ACCEL_4_G:  return ACCEL_PER_DIGIT_4_G;
+        case ACCEL_8_G:  return ACCEL_PER_DIGIT_8_G;
+        case ACCEL_16_G: return ACCEL_PER_DIGIT_16_G;
+    }
+    throw std::invalid_argument("invalid accel range");
+}
+
+constexpr float gyro_per_digit(gyro_range_t range) {
+    switch (range) {
+        case GYRO_250_DPS:  return GYRO_PER_DIGIT_250_DPS;
+        case GYRO_500_DPS:  return GYRO_PER_DIGIT_500_DPS;
+        case GYRO_1000_DPS: return GYRO_PER_DIGIT_1000_DPS;
+        case GYRO_2000_DPS: return GYRO_PER_DIGIT_2000_DPS;
+    }
+    throw std::invalid_argument("invalid gyro range");
+}
+
+/**
+ * @brief Connection to the pigpiod daemon, closed on destruction
+*/
+class pigpiod {
+public:
+    /**
+     * @param addr Hostname or IP address, LOCALHOST for local machine
+     * @param port TCP port, DEFAULT_PORT for default port
+     * @throw imu::error if the daemon cannot be reached
+    */
+    explicit pigpiod(const char* addr = LOCALHOST, const char* port = DEFAULT_PORT)
+        : pi_(pigpiod_daemon_open(addr, port)) {
+        if (pi_ < 0) throw error("failed to connect pigpiod daemon", pi_);
+    }
+
+    ~pigpiod() {
+        if (pi_ >= 0) pigpiod_daemon_close(pi_);
+    }
+
+    pigpiod(const pigpiod&) = delete;
+    pigpiod& operator=(const pigpiod&) = delete;
+
+    pigpiod(pigpiod&& other) noexcept : pi_(std::exchange(other.pi_, -1)) {}
+    pigpiod& operator=(pigpiod&& other) noexcept {
+        if (this != &other) {
+            if (pi_ >= 0) pigpiod_daemon_close(pi_);
+            pi_ = std::exchange(other.pi_, -1);
+        }
+        return *this;
+    }
+
+    /** @return Pigpio handle */
+    int handle() const noexcept { return pi_; }
+
+private:
+    int pi_;
+};
+
+/**
+ * @brief One accel / gyro sample in physical units
+*/
+struct sample {
+    vec3f_t accel; // [g]
+    vec3f_t gyro;  // [deg / s]
+};
+
+/**
+ * @brief I2C session with a MPU-6050 configured for fixed ranges
+ *
+ * The ranges are written to the sensor on construction and the session is
+ * ended on destruction. The daemon must outlive the session.
+ *
+ * @tparam Accel Accelerometer range
+ * @tparam Gyro  Gyroscope range
+*/
+template <accel_range_t Accel, gyro_range_t Gyro>
+class session {
+public:
+    static constexpr float accel_scale = accel_per_digit(Accel);
+    static constexpr float gyro_scale  = gyro_per_digit(Gyro);
+
+    /**
+     * @param d Connected daemon
+     * @param bus I2C bus number
+     * @param addr I2C address
+     * @throw imu::error if the session cannot be started or the ranges cannot be set
+    */
+    explicit session(const pigpiod& d, unsigned int bus = BUS_DEV_I2C_1, unsigned int addr = MPU6050_I2C_ADDR)
+        : pi_(d.handle()), handle_(i2c_begin_session(pi_, bus, addr)) {
+        if (handle_ < 0) throw error("failed to begin i2c session", handle_);
+
+        int rc = set_sensor_range(pi_, (unsigned int)handle_, SENS_ACCEL, (uint8_t)Accel);
+        if (rc == RC_OK) rc = set_sensor_range(pi_, (unsigned int)handle_, SENS_GYRO, (uint8_t)Gyro);
+        if (rc != RC_OK) {
+            (void)i2c_end_session(pi_, (unsigned int)handle_);
+            throw error("failed to set sensor range", rc);
+        }
+    }
+
+    ~session() {
+        if (handle_ >= 0) (void)i2c_end_session(pi_, (unsigned int)handle_);
+    }
+
+    session(const session&) = delete;
+    session& operator=(const session&) = delete;
+
+    session(session&& other) noexcept
+        : pi_(other.pi_), handle_(std::exchange(other.handle_, -1)) {}
+    session& operator=(session&& other) noexcept {
+        if (this != &other) {
+            if (handle_ >= 0) (void)i2c_end_session(pi_, (unsigned int)handle_);
+            pi_ = other.pi_;
+            handle_ = std::exchange(other.handle_, -1);
+        }
+        return *this;
+    }
+
+    /** @return RC_OK if OK, otherwise RC_FAIL_SET */
+    int set_dlpf(dlpf_cfg_t cfg) noexcept { return set_dlpf_cfg(pi_, (unsigned int)handle_, cfg); }
+
+    /** @return RC_OK if OK, otherwise RC_FAIL_SET */
+    int set_sample_rate_div(uint8_t div) noexcept { return set_sample_rate(pi_, (unsigned int)handle_, div); }
+
+    /**
+     * @brief Read one accel / gyro sample in a single burst
+     * @return RC_OK if OK, otherwise RC_FAIL_GET
+    */
+    int read(sample& dst) noexcept {
+        sensor_data_real_fast_t a{SENS_ACCEL, accel_scale, {}};
+        sensor_data_real_fast_t g{SENS_GYRO, gyro_scale, {}};
+
+        int rc = get_accel_gyro_data_real_fast(pi_, (unsigned int)handle_, &a, &g);
+        if (rc != RC_OK) return rc;
+        dst.accel = a.vec;
+        dst.gyro  = g.vec;
+        return RC_OK;
+    }
+
+    /**
+     * @brief Read one accel / gyro sample and the external sensor payload in a single burst
+     * @param[out] ext ext_sens_data_t containing the number of bytes configured with enable_aux_i2c_slave0
+     * @return RC_OK if OK, otherwise RC_INVALID_ARGUMENT, RC_FAIL_GET
+    */
+    int read(sample& dst, ext_sens_data_t& ext) noexcept {
+        sensor_data_real_fast_t a{SENS_ACCEL, accel_scale, {}};
+        sensor_data_real_fast_t g{SENS_GYRO, gyro_scale, {}};
+
+        int rc = get_accel_gyro_ext_data_real_fast(pi_, (unsigned int)handle_, &a, &g, &ext);
+        if (rc != RC_OK) return rc;
+        dst.accel = a.vec;
+        dst.gyro  = g.vec;
+        return RC_OK;
+    }
+
+    /**
+     * @brief Enable the accel / gyro FIFO used by read(std::span<sample>) and reset it
+     * @return RC_OK if OK, otherwise RC_FAIL_SET
+    */
+    int enable_fifo() noexcept { return ::enable_fifo(pi_, (unsigned int)handle_, FIFO_EN_ACCEL | FIFO_EN_GYRO); }
+
+    /** @return RC_OK if OK, otherwise RC_FAIL_SET */
+    int disable_fifo() noexcept { return ::disable_fifo(pi_, (unsigned int)handle_); }
+
+    /**
+     * @brief Drain up to dst.size() buffered samples from the FIFO in one burst
+     *
+     * The FIFO must be enabled with enable_fifo(). Samples are decoded with the
+     * compile-time scales. If the FIFO count is not frame aligned (overflow or
+     * lost alignment) the FIFO is reset and nothing is returned.
+     *
+     * @return Number of samples read (0 - dst.size()) if OK, otherwise
+     *      RC_SAMPLES_LOST (the FIFO was reset), RC_FAIL_GET, RC_FAIL_SET
+    */
+    int read(std::span<sample> dst) noexcept {
+        uint16_t count;
+        if (get_fifo_count(pi_, (unsigned int)handle_, &count) != RC_OK) return RC_FAIL_GET;
+
+        if ((count % FIFO_FRAME_ACCEL_GYRO) != 0) {
+            if (reset_fifo(pi_, (unsigned int)handle_) != RC_OK) return RC_FAIL_SET;
+            return RC_SAMPLES_LOST;
+        }
+
+        std::size_t frames = count / FIFO_FRAME_ACCEL_GYRO;
+        if (frames > dst.size()) frames = dst.size();
+        if (frames == 0) return 0;
+
+        std::array<uint8_t, FIFO_SIZE> buf;
+        if (read_fifo(pi_, (unsigned int)handle_, buf.data(), (unsigned int)(frames * FIFO_FRAME_ACCEL_GYRO)) != RC_OK) return RC_FAIL_GET;
+
+        for (std::size_t i = 0; i < frames; ++i) {
+            const uint8_t* f = &buf[i * FIFO_FRAME_ACCEL_GYRO];
+            dst[i].accel = {be16(&f[0]) * accel_scale, be16(&f[2]) * accel_scale, be16(&f[4]) * accel_scale};
+            dst[i].gyro  = {be16(&f[6]) * gyro_scale,  be16(&f[8]) * gyro_scale,  be16(&f[10]) * gyro_scale};
+        }
+        return (int)frames;
+    }
+
+    /** @return Pigpio handle */
+    int pi() const noexcept { return pi_; }
+
+    /** @return I2C session handle */
+    unsigned int handle() const noexcept { return (unsigned int)handle_; }
+
+private:
+    static constexpr float be16(const uint8_t* p) noexcept {
+        return (float)(int16_t)((p[0] << 8) | p[1]);
+    }
+
+    int pi_;
+    int handle_;
+};
+
+} // namespace imu
+
+#endif //LMP_PROJECT_HARDWARE_IMU_MPU_6050_HPP_
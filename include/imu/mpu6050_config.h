@@ -25,6 +25,34 @@
 #define PWR_MGMT_WARE_UP     0x00
 #define PWR_MGMT_SLEEP       0x40
 
+/* Auxiliary I2C master */
+#define USER_CTRL_I2C_MST_EN      0x20
+#define INT_PIN_CFG_I2C_BYPASS_EN 0x02
+#define I2C_MST_CLK_400_KHZ       0x0D
+#define I2C_SLV_RNW               0x80
+#define I2C_SLV_EN                0x80
+#define I2C_SLV_LEN_MAX           15
+#define EXT_SENS_DATA_MAX         I2C_SLV_LEN_MAX
+
+/* FIFO */
+#define FIFO_SIZE                 1024
+#define FIFO_EN_TEMP              0x80
+#define FIFO_EN_XG                0x40
+#define FIFO_EN_YG                0x20
+#define FIFO_EN_ZG                0x10
+#define FIFO_EN_GYRO              (FIFO_EN_XG | FIFO_EN_YG | FIFO_EN_ZG)
+#define FIFO_EN_ACCEL             0x08
+#define FIFO_EN_SLV0              0x01
+#define FIFO_FRAME_ACCEL_GYRO     12
+#define USER_CTRL_FIFO_EN         0x40
+#define USER_CTRL_FIFO_RESET      0x04
+#define INT_FIFO_OFLOW            0x10
+#define INT_DATA_RDY              0x01
+
+/* Gyro output rate (DLPF off: DLPF_CFG_0 / DLPF_CFG_7), the sample rate is GYRO_OUTPUT_RATE / (1 + SMPLRT_DIV) */
+#define GYRO_OUTPUT_RATE_DLPF_OFF 8000.0f
+#define GYRO_OUTPUT_RATE_DLPF_ON  1000.0f
+
 /* Register map */
 #define REGMAP_SMPLRATE_DIV  0x19
 
@@ -32,6 +60,17 @@
 #define REGMAP_GYRO_CONFIG   0x1B
 #define REGMAP_ACCEL_CONFIG  0x1C
 
+#define REGMAP_FIFO_EN       0x23
+
+#define REGMAP_I2C_MST_CTRL  0x24
+#define REGMAP_I2C_SLV0_ADDR 0x25
+#define REGMAP_I2C_SLV0_REG  0x26
+#define REGMAP_I2C_SLV0_CTRL 0x27
+
+#define REGMAP_INT_PIN_CFG   0x37
+#define REGMAP_INT_ENABLE    0x38
+#define REGMAP_INT_STATUS    0x3A
+
 #define REGMAP_ACCEL_XOUT_H  0x3B
 #define REGMAP_ACCEL_XOUT_L  0x3C
 #define REGMAP_ACCEL_YOUT_H  0x3D
@@ -49,9 +88,17 @@
 #define REGMAP_GYRO_ZOUT_H   0x47
 #define REGMAP_GYRO_ZOUT_L   0x48
 
+#define REGMAP_EXT_SENS_DATA_00 0x49
+
+#define REGMAP_USER_CTRL     0x6A
+
 #define REGMAP_PWR_MGMT_1    0x6B
 #define REGMAP_PWR_MGMT_2    0x6C
 
+#define REGMAP_FIFO_COUNTH   0x72
+#define REGMAP_FIFO_COUNTL   0x73
+#define REGMAP_FIFO_R_W      0x74
+
 #define REGMAP_WHO_AM_I      0x75
 
 /* LSB sensitivity */
@@ -103,6 +150,7 @@ typedef enum {
 	DLPF_CFG_4  = 0x04, /*  21Hz accel /  20Hz gyro */
 	DLPF_CFG_5  = 0x05, /*  10Hz accel /  10Hz gyro */
 	DLPF_CFG_6  = 0x06, /*   5Hz accel /   5Hz gyro */
+	DLPF_CFG_7  = 0x07, /* reserved, gyro output rate as DLPF_CFG_0 */
 } dlpf_cfg_t;
 
 typedef struct {
@@ -123,4 +171,15 @@ typedef struct {
     vec3f_t vec;
 } sensor_data_real_fast_t;
 
+typedef struct {
+    uint8_t addr; // 7-bit I2C address of the external sensor
+    uint8_t reg;  // first register to read on the external sensor
+    uint8_t len;  // number of bytes to read (1 - I2C_SLV_LEN_MAX)
+} aux_i2c_slave_cfg_t;
+
+typedef struct {
+    uint8_t len;                     // number of bytes to read, must match aux_i2c_slave_cfg_t.len
+    uint8_t data[EXT_SENS_DATA_MAX]; // raw bytes as read from the external sensor
+} ext_sens_data_t;
+
 #endif //LMP_PROJECT_HARDWARE_IMU_MPU6050_CONFIG_H_
@@ -14,5 +14,7 @@
 #define RC_RESOURCE_UNAVAILABLE -10
 #define RC_FAIL_SET             -11
 #define RC_FAIL_GET             -12
+#define RC_FAIL_FILE_IO         -13
+#define RC_SAMPLES_LOST         -14
 
 #endif //LMP_PROJECT_HARDWARE_IMU_RETURN_CODE_H_
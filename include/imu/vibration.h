@@ -0,0 +1,124 @@
+#ifndef LMP_PROJECT_HARDWARE_IMU_VIBRATION_H_
+#define LMP_PROJECT_HARDWARE_IMU_VIBRATION_H_
+
+#include "imu/common.h"
+
+/**
+ * @file vibration.h
+ * @brief Streaming vibration spectrum analysis (Welch PSD, RMS, peak frequencies) of accelerometer data
+ *
+ * Samples are pushed as they are read. Every fft_len / 2 samples a Hann windowed,
+ * mean removed segment of fft_len samples (50% overlap) is transformed and its
+ * one-sided PSD is added to the running average. All buffers are allocated
+ * once in vib_analyzer_init().
+*/
+
+#define VIB_AXES        3
+#define VIB_AXIS_X      0
+#define VIB_AXIS_Y      1
+#define VIB_AXIS_Z      2
+
+#define VIB_FFT_LEN_MIN 16
+#define VIB_FFT_LEN_MAX 65536
+#define VIB_PEAKS_MAX   8
+#define VIB_PEAK_REL_MIN 1e-9f  /* default peak_rel_min (-90 dB), above float rounding residue */
+
+#ifdef __cplusplus
+extern "C" {
+#endif //__cplusplus
+
+typedef struct {
+    unsigned int fft_len;   // segment length, power of 2 (VIB_FFT_LEN_MIN - VIB_FFT_LEN_MAX)
+    float sample_rate_hz;   // output data rate of the pushed samples
+    unsigned int n_peaks;   // number of peak frequencies to report (0 - VIB_PEAKS_MAX)
+    float peak_rel_min;     // peaks below this fraction of the highest PSD bin are not reported, 0 for VIB_PEAK_REL_MIN
+} vib_config_t;
+
+typedef struct {
+    float freq_hz;          // peak frequency [Hz]
+    float psd;              // PSD at the peak [g^2 / Hz]
+} vib_peak_t;
+
+typedef struct {
+    float rms;              // RMS of the AC part [g], integrated over the averaged PSD
+    unsigned int n_peaks;   // number of valid entries in peaks
+    vib_peak_t peaks[VIB_PEAKS_MAX]; // sorted by descending PSD, at least peak_rel_min of the maximum
+} vib_axis_result_t;
+
+typedef struct {
+    vib_config_t cfg;
+    unsigned int log2_len;
+    float* window;          // fft_len
+    float* twiddle_re;      // fft_len / 2
+    float* twiddle_im;      // fft_len / 2
+    uint32_t* bitrev;       // fft_len
+    float* ring;            // VIB_AXES * fft_len, one contiguous ring per axis
+    float* work_re;         // fft_len
+    float* work_im;         // fft_len
+    float* psd_acc;         // VIB_AXES * (fft_len / 2 + 1), summed over segments
+    float psd_scale;        // 1 / (fs * sum(w^2))
+    unsigned int head;      // next write position in the rings
+    unsigned int filled;    // samples in the rings, saturates at fft_len
+    unsigned int pending;   // samples since the last segment
+    unsigned int n_segments;
+} vib_analyzer_t;
+
+/**
+ * @brief Allocate buffers and precompute window / twiddle tables
+ *
+ * @param an Analyzer to initialize
+ * @param cfg Configuration
+ * @return RC_OK if OK, otherwise RC_INVALID_ARGUMENT, RC_RESOURCE_UNAVAILABLE
+*/
+int vib_analyzer_init(vib_analyzer_t* an, const vib_config_t* cfg);
+
+/**
+ * @brief Release buffers allocated by vib_analyzer_init()
+ *
+ * @param an Analyzer
+*/
+void vib_analyzer_free(vib_analyzer_t* an);
+
+/**
+ * @brief Discard buffered samples and the averaged PSD
+ *
+ * @param an Analyzer
+*/
+void vib_analyzer_reset(vib_analyzer_t* an);
+
+/**
+ * @brief Push accelerometer samples
+ *
+ * @param an Analyzer
+ * @param samples Samples in physical units [g]
+ * @param n Number of samples
+ * @return Number of segments added to the average (>= 0)
+*/
+int vib_analyzer_push(vib_analyzer_t* an, const vec3f_t* samples, unsigned int n);
+
+/**
+ * @brief Copy the averaged one-sided PSD of an axis
+ *
+ * @param an Analyzer
+ * @param axis VIB_AXIS_X, VIB_AXIS_Y or VIB_AXIS_Z
+ * @param[out] dst Destination, bin k is at k * sample_rate_hz / fft_len [Hz]
+ * @param n Size of dst, must be >= fft_len / 2 + 1
+ * @return RC_OK if OK, otherwise RC_INVALID_ARGUMENT, RC_FAIL_GET (no segment yet)
+*/
+int vib_analyzer_get_psd(const vib_analyzer_t* an, unsigned int axis, float* dst, unsigned int n);
+
+/**
+ * @brief Get RMS and peak frequencies of an axis from the averaged PSD
+ *
+ * @param an Analyzer
+ * @param axis VIB_AXIS_X, VIB_AXIS_Y or VIB_AXIS_Z
+ * @param[out] dst Pointer to store the result
+ * @return RC_OK if OK, otherwise RC_INVALID_ARGUMENT, RC_FAIL_GET (no segment yet)
+*/
+int vib_analyzer_get_result(const vib_analyzer_t* an, unsigned int axis, vib_axis_result_t* dst);
+
+#ifdef __cplusplus
+}
+#endif //__cplusplus
+
+#endif //LMP_PROJECT_HARDWARE_IMU_VIBRATION_H_
@@ -0,0 +1,167 @@
+#include "imu/batch.h"
+#include "imu/mpu6050.h"
+
+static inline int16_t be16(const uint8_t* p) {
+    return (int16_t)((p[0] << 8) | p[1]);
+}
+
+/* Decode count accel + gyro frames in place of the slot's arrays */
+static void decode_frames(const imu_batch_consumer_t* c, imu_batch_slot_t* s, unsigned int count) {
+    const float apd = c->accel_per_digit;
+    const float gpd = c->gyro_per_digit;
+
+    for (unsigned int i = 0; i < count; ++i) {
+        const uint8_t* f = &s->fifo[i * FIFO_FRAME_ACCEL_GYRO];
+        vec3i_t* a = &s->accel_raw[i];
+        vec3i_t* g = &s->gyro_raw[i];
+
+        a->x = be16(&f[0]);
+        a->y = be16(&f[2]);
+        a->z = be16(&f[4]);
+        g->x = be16(&f[6]);
+        g->y = be16(&f[8]);
+        g->z = be16(&f[10]);
+
+        s->accel[i].x = (float)a->x * apd;
+        s->accel[i].y = (float)a->y * apd;
+        s->accel[i].z = (float)a->z * apd;
+        s->gyro[i].x  = (float)g->x * gpd;
+        s->gyro[i].y  = (float)g->y * gpd;
+        s->gyro[i].z  = (float)g->z * gpd;
+    }
+}
+
+static imu_batch_slot_t* acquire_slot(imu_batch_consumer_t* c) {
+    for (unsigned int i = 0; i < c->n_slots; ++i) {
+        unsigned int idx = (c->next + i) % c->n_slots;
+        if (!c->slots[idx].in_use) {
+            c->next = (idx + 1) % c->n_slots;
+            return &c->slots[idx];
+        }
+    }
+    return NULL;
+}
+
+int imu_batch_consumer_init(imu_batch_consumer_t* c, unsigned int n_buffers, float accel_per_digit, float gyro_per_digit, imu_batch_cb_t cb, void* user) {
+    assert(c != NULL);
+
+    memset(c, 0, sizeof(*c));
+    if (cb == NULL || n_buffers == 0 || n_buffers > IMU_BATCH_BUFFERS_MAX) return RC_INVALID_ARGUMENT;
+
+    const size_t raw_size  = IMU_BATCH_FRAMES_MAX * sizeof(vec3i_t);
+    const size_t real_size = IMU_BATCH_FRAMES_MAX * sizeof(vec3f_t);
+    const size_t slot_size = 2 * real_size + 2 * raw_size + FIFO_SIZE;
+
+    uint8_t* block = malloc(n_buffers * slot_size);
+    if (block == NULL) return RC_RESOURCE_UNAVAILABLE;
+
+    for (unsigned int i = 0; i < n_buffers; ++i) {
+        uint8_t* p = block + i * slot_size;
+        imu_batch_slot_t* s = &c->slots[i];
+
+        /* Widest members first to keep every array aligned */
+        s->accel     = (vec3f_t*)p; p += real_size;
+        s->gyro      = (vec3f_t*)p; p += real_size;
+        s->accel_raw = (vec3i_t*)p; p += raw_size;
+        s->gyro_raw  = (vec3i_t*)p; p += raw_size;
+        s->fifo      = p;
+
+        s->view.accel_raw = s->accel_raw;
+        s->view.gyro_raw  = s->gyro_raw;
+        s->view.accel     = s->accel;
+        s->view.gyro      = s->gyro;
+        s->view.slot      = i;
+    }
+
+    c->cb = cb;
+    c->user = user;
+    c->accel_per_digit = accel_per_digit;
+    c->gyro_per_digit = gyro_per_digit;
+    c->n_slots = n_buffers;
+    c->block = block;
+    return RC_OK;
+}
+
+void imu_batch_consumer_free(imu_batch_consumer_t* c) {
+    assert(c != NULL);
+
+    free(c->block);
+    memset(c, 0, sizeof(*c));
+}
+
+int imu_batch_poll(int pi, unsigned int handle, imu_batch_consumer_t* c, fifo_monitor_t* mon) {
+    assert(pi >= 0);
+    assert(c != NULL && c->block != NULL);
+    assert(mon == NULL || mon->frame_size == FIFO_FRAME_ACCEL_GYRO);
+
+    imu_batch_slot_t* s = acquire_slot(c);
+    if (s == NULL) return RC_RESOURCE_UNAVAILABLE;
+
+    unsigned int frames;
+    if (mon != NULL) {
+        /* Samples already in the FIFO were taken before any rate change made by this poll */
+        if (c->fifo_rate_hz == 0.0f) c->fifo_rate_hz = mon->rate_hz;
+
+        fifo_poll_t st;
+        int rc = fifo_monitor_poll(pi, handle, mon, &st);
+        if (rc != RC_OK) return rc;
+
+        const float batch_rate_hz = c->fifo_rate_hz;
+        c->fifo_rate_hz = mon->rate_hz;
+
+        if (st.lost > 0 || st.overflow || st.misaligned) {
+            c->pending_lost += st.lost;
+            c->pending_overflow |= st.overflow;
+            c->next_sample += st.lost;
+            return RC_SAMPLES_LOST;
+        }
+        frames = st.frames;
+        s->view.rate_hz = batch_rate_hz;
+    }
+    else {
+        uint16_t count;
+        if (get_fifo_count(pi, handle, &count) != RC_OK) return RC_FAIL_GET;
+
+        /* Without a monitor only the discarded frames are known to be lost; a full FIFO is never frame aligned */
+        if (unlikely((count % FIFO_FRAME_ACCEL_GYRO) != 0)) {
+            if (reset_fifo(pi, handle) != RC_OK) return RC_FAIL_SET;
+            c->pending_lost += count / FIFO_FRAME_ACCEL_GYRO;
+            c->pending_overflow |= (count == FIFO_SIZE);
+            c->next_sample += count / FIFO_FRAME_ACCEL_GYRO;
+            return RC_SAMPLES_LOST;
+        }
+        frames = count / FIFO_FRAME_ACCEL_GYRO;
+        s->view.rate_hz = 0.0f;
+    }
+
+    if (frames == 0) return 0;
+    if (frames > IMU_BATCH_FRAMES_MAX) frames = IMU_BATCH_FRAMES_MAX;
+
+    if (read_fifo(pi, handle, s->fifo, frames * FIFO_FRAME_ACCEL_GYRO) != RC_OK) return RC_FAIL_GET;
+    if (mon != NULL) fifo_monitor_consumed(mon, frames);
+
+    decode_frames(c, s, frames);
+    s->view.count = frames;
+    s->view.seq = c->seq++;
+    s->view.first_sample = c->next_sample;
+    s->view.lost = c->pending_lost;
+    s->view.overflow = c->pending_overflow;
+    s->view.rate_changed = (c->last_rate_hz != 0.0f && s->view.rate_hz != c->last_rate_hz);
+    s->in_use = true;
+
+    c->next_sample += frames;
+    c->pending_lost = 0;
+    c->pending_overflow = false;
+    c->last_rate_hz = s->view.rate_hz;
+
+    c->cb(&s->view, c->user);
+    return (int)frames;
+}
+
+void imu_batch_release(imu_batch_consumer_t* c, const imu_batch_view_t* view) {
+    assert(c != NULL && view != NULL);
+    assert(view->slot < c->n_slots);
+    assert(c->slots[view->slot].in_use);
+
+    c->slots[view->slot].in_use = false;
+}
@@ -0,0 +1,153 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include "imu/fifo_monitor.h"
+#include "imu/mpu6050.h"
+
+#include <time.h>
+
+static inline double monotonic_s(void) {
+    struct timespec ts;
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static inline float sample_rate_hz(float base_rate_hz, uint8_t div) {
+    return base_rate_hz / (1.0f + (float)div);
+}
+
+static int apply_div(int pi, unsigned int handle, fifo_monitor_t* mon, uint8_t div) {
+    if (div == mon->div) return RC_OK;
+    if (set_sample_rate(pi, handle, div) != RC_OK) return RC_FAIL_SET;
+
+    mon->div = div;
+    mon->rate_hz = sample_rate_hz(mon->base_rate_hz, div);
+    mon->rate_changes++;
+    return RC_OK;
+}
+
+/* Lower the rate by ~25% at once, raise it one step at a time */
+static int control_rate(int pi, unsigned int handle, fifo_monitor_t* mon, bool overflow, float fill, bool* changed) {
+    const rate_ctrl_cfg_t* c = &mon->ctrl;
+    unsigned int div = mon->div;
+
+    if (overflow || fill > c->high_watermark) {
+        mon->low_streak = 0;
+        div += 1u + div / 4u;
+        if (div > c->div_max) div = c->div_max;
+        if (div < mon->div) div = mon->div;     /* never raise the rate on overflow */
+    }
+    else if (fill < c->low_watermark) {
+        if (++mon->low_streak < c->raise_after) return RC_OK;
+        mon->low_streak = 0;
+        if (div > c->div_min) div--;
+    }
+    else {
+        mon->low_streak = 0;
+        return RC_OK;
+    }
+
+    uint8_t prev = mon->div;
+    if (apply_div(pi, handle, mon, (uint8_t)div) != RC_OK) return RC_FAIL_SET;
+    *changed = (mon->div != prev);
+    return RC_OK;
+}
+
+int fifo_monitor_init(int pi, unsigned int handle, fifo_monitor_t* mon, unsigned int frame_size, const rate_ctrl_cfg_t* ctrl) {
+    assert(pi >= 0);
+    assert(mon != NULL);
+
+    if (frame_size == 0 || frame_size > FIFO_SIZE) return RC_INVALID_ARGUMENT;
+    if (ctrl != NULL) {
+        if (ctrl->div_min > ctrl->div_max) return RC_INVALID_ARGUMENT;
+        if (!(ctrl->low_watermark >= 0.0f && ctrl->low_watermark < ctrl->high_watermark && ctrl->high_watermark <= 1.0f))
+            return RC_INVALID_ARGUMENT;
+    }
+
+    memset(mon, 0, sizeof(*mon));
+
+    dlpf_cfg_t dlpf;
+    if (get_sample_rate(pi, handle, &mon->div) != RC_OK) return RC_FAIL_GET;
+    if (get_dlpf_cfg(pi, handle, &dlpf) != RC_OK) return RC_FAIL_GET;
+
+    mon->frame_size = frame_size;
+    mon->capacity = FIFO_SIZE / frame_size;
+    mon->base_rate_hz = (dlpf == DLPF_CFG_0 || dlpf == DLPF_CFG_7) ? GYRO_OUTPUT_RATE_DLPF_OFF : GYRO_OUTPUT_RATE_DLPF_ON;
+    mon->rate_hz = sample_rate_hz(mon->base_rate_hz, mon->div);
+
+    if (ctrl != NULL) {
+        mon->adaptive = true;
+        mon->ctrl = *ctrl;
+
+        /* Start inside the range the controller may select */
+        uint8_t div = mon->div;
+        if (div < ctrl->div_min) div = ctrl->div_min;
+        if (div > ctrl->div_max) div = ctrl->div_max;
+        if (apply_div(pi, handle, mon, div) != RC_OK) return RC_FAIL_SET;
+    }
+
+    mon->last_poll_s = monotonic_s();
+    return RC_OK;
+}
+
+int fifo_monitor_poll(int pi, unsigned int handle, fifo_monitor_t* mon, fifo_poll_t* dst) {
+    assert(pi >= 0);
+    assert(mon != NULL && dst != NULL);
+
+    memset(dst, 0, sizeof(*dst));
+
+    uint8_t status;
+    uint16_t count;
+    if (get_int_status(pi, handle, &status) != RC_OK) return RC_FAIL_GET;
+    if (get_fifo_count(pi, handle, &count) != RC_OK) return RC_FAIL_GET;
+
+    const double now = monotonic_s();
+    const double produced = (now - mon->last_poll_s) * (double)mon->rate_hz;
+    mon->last_poll_s = now;
+
+    /* A full FIFO keeps accepting data and overwrites the oldest bytes */
+    if (unlikely((status & INT_FIFO_OFLOW) != 0)) {
+        if (reset_fifo(pi, handle) != RC_OK) return RC_FAIL_SET;
+
+        double lost = (double)mon->backlog + produced;
+        if (lost < (double)(mon->capacity + 1)) lost = (double)(mon->capacity + 1);
+
+        dst->overflow = true;
+        dst->lost = (unsigned int)(lost + 0.5);
+        mon->samples_lost += dst->lost;
+        mon->overflow_events++;
+        mon->backlog = 0;
+#ifdef DEBUG
+        debug_log(stderr, "[fifo monitor]: FIFO overflow, ~%u samples lost \n", dst->lost);
+#endif //DEBUG
+    }
+    /* Frame alignment lost without an overflow, only the discarded frames are lost */
+    else if (unlikely((count % mon->frame_size) != 0)) {
+        if (reset_fifo(pi, handle) != RC_OK) return RC_FAIL_SET;
+
+        dst->misaligned = true;
+        dst->lost = count / mon->frame_size;
+        mon->samples_lost += dst->lost;
+        mon->misaligned_events++;
+        mon->backlog = 0;
+#ifdef DEBUG
+        debug_log(stderr, "[fifo monitor]: FIFO misaligned, %u samples discarded \n", dst->lost);
+#endif //DEBUG
+    }
+    else {
+        dst->frames = count / mon->frame_size;
+        mon->backlog = dst->frames;
+    }
+
+    if (mon->adaptive) {
+        const float fill = dst->overflow ? 1.0f : (float)count / (float)FIFO_SIZE;
+        if (control_rate(pi, handle, mon, dst->overflow, fill, &dst->rate_changed) != RC_OK) return RC_FAIL_SET;
+    }
+    return RC_OK;
+}
+
+void fifo_monitor_consumed(fifo_monitor_t* mon, unsigned int frames) {
+    assert(mon != NULL);
+
+    mon->samples_read += frames;
+    mon->backlog = (frames < mon->backlog) ? mon->backlog - frames : 0;
+}
@@ -0,0 +1,64 @@
+#define _FILE_OFFSET_BITS 64
+
+#include "imu/frame_log.h"
+
+#include <assert.h>
+#include <stddef.h>
+
+#define FRAME_LOG_STAGE 256
+
+int frame_log_open(frame_log_t* log, const char* path, float sample_rate_hz, float accel_per_digit, float gyro_per_digit) {
+    assert(log != NULL);
+    assert(path != NULL);
+
+    log->fp = NULL;
+    if (!(sample_rate_hz > 0.0f)) return RC_INVALID_ARGUMENT;
+
+    const frame_log_header_t hdr = {
+        .magic = FRAME_LOG_MAGIC,
+        .version = FRAME_LOG_VERSION,
+        .frame_size = (uint16_t)sizeof(imu_frame_t),
+        .sample_rate_hz = sample_rate_hz,
+        .accel_per_digit = accel_per_digit,
+        .gyro_per_digit = gyro_per_digit,
+        .reserved = 0,
+    };
+
+    FILE* fp = fopen(path, "wb");
+    if (fp == NULL) return RC_FAIL_FILE_IO;
+    if (fwrite(&hdr, sizeof(hdr), 1, fp) != 1) {
+        (void)fclose(fp);
+        return RC_FAIL_FILE_IO;
+    }
+
+    log->fp = fp;
+    return RC_OK;
+}
+
+int frame_log_append(frame_log_t* log, const vec3i_t* accel, const vec3i_t* gyro, unsigned int n) {
+    assert(log != NULL && log->fp != NULL);
+    assert((accel != NULL && gyro != NULL) || n == 0);
+
+    imu_frame_t stage[FRAME_LOG_STAGE];
+
+    for (unsigned int done = 0; done < n; ) {
+        unsigned int m = n - done;
+        if (m > FRAME_LOG_STAGE) m = FRAME_LOG_STAGE;
+
+        for (unsigned int i = 0; i < m; ++i) {
+            stage[i].accel = accel[done + i];
+            stage[i].gyro = gyro[done + i];
+        }
+        if (fwrite(stage, sizeof(imu_frame_t), m, log->fp) != m) return RC_FAIL_FILE_IO;
+        done += m;
+    }
+    return RC_OK;
+}
+
+int frame_log_close(frame_log_t* log) {
+    assert(log != NULL && log->fp != NULL);
+
+    int rc = (fclose(log->fp) == 0) ? RC_OK : RC_FAIL_FILE_IO;
+    log->fp = NULL;
+    return rc;
+}
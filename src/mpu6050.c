@@ -20,7 +20,7 @@ static inline int write_register_8(int pi, unsigned int handle, unsigned int reg
 }
 
 static int read_data_n(int pi, unsigned int handle, unsigned int reg_start, uint8_t* buf, unsigned int n) {
-    assert(n > 0 && n < 15);
+    assert(n > 0 && n <= 14 + EXT_SENS_DATA_MAX);
     assert((reg_start & ~0xFFu) == 0);
 
     if (n == 1) { 
@@ -125,6 +125,25 @@ static inline float lsb_sensitivity(imu_sensor_data_t sens, uint8_t flag) {
     }
 }
 
+static inline void convert_accel_gyro(const uint8_t* buf, sensor_data_real_fast_t* accel, sensor_data_real_fast_t* gyro) {
+    vec3i_t accel_raw, gyro_raw;
+
+    accel_raw.x = (int16_t)((buf[0] << 8) | buf[1]);
+    accel_raw.y = (int16_t)((buf[2] << 8) | buf[3]);
+    accel_raw.z = (int16_t)((buf[4] << 8) | buf[5]);
+    
+    gyro_raw.x = (int16_t)((buf[8] << 8)  | buf[9]);
+    gyro_raw.y = (int16_t)((buf[10] << 8) | buf[11]);
+    gyro_raw.z = (int16_t)((buf[12] << 8) | buf[13]);
+
+    accel->vec.x = (float)accel_raw.x * accel->per_digit;
+    accel->vec.y = (float)accel_raw.y * accel->per_digit;
+    accel->vec.z = (float)accel_raw.z * accel->per_digit;
+
+    gyro->vec.x = (float)gyro_raw.x * gyro->per_digit;
+    gyro->vec.y = (float)gyro_raw.y * gyro->per_digit;
+    gyro->vec.z = (float)gyro_raw.z * gyro->per_digit;
+}
 
 int i2c_begin_session(int pi, unsigned int bus, unsigned int addr) {
     assert(pi >= 0);
@@ -297,23 +316,166 @@ int get_accel_gyro_data_real_fast(int pi, unsigned int handle, sensor_data_real_
     unsigned int size = sizeof(buf);
     if (read_data_n(pi, handle, REGMAP_ACCEL_XOUT_H, buf, size) != size) return RC_FAIL_GET;
     
-    vec3i_t accel_raw, gyro_raw;
+    convert_accel_gyro(buf, accel, gyro);
+    return RC_OK;
+}
 
-    accel_raw.x = (int16_t)((buf[0] << 8) | buf[1]);
-    accel_raw.y = (int16_t)((buf[2] << 8) | buf[3]);
-    accel_raw.z = (int16_t)((buf[4] << 8) | buf[5]);
-    
-    gyro_raw.x = (int16_t)((buf[8] << 8)  | buf[9]);
-    gyro_raw.y = (int16_t)((buf[10] << 8) | buf[11]);
-    gyro_raw.z = (int16_t)((buf[12] << 8) | buf[13]);
+int set_aux_i2c_bypass(int pi, unsigned int handle, bool enable) {
+    assert(pi >= 0);
 
-    accel->vec.x = (float)accel_raw.x * accel->per_digit;
-    accel->vec.y = (float)accel_raw.y * accel->per_digit;
-    accel->vec.z = (float)accel_raw.z * accel->per_digit;
+    uint8_t value;
 
-    gyro->vec.x = (float)gyro_raw.x * gyro->per_digit;
-    gyro->vec.y = (float)gyro_raw.y * gyro->per_digit;
-    gyro->vec.z = (float)gyro_raw.z * gyro->per_digit;
+    do {
+        /* The bypass mux has no effect while the auxiliary I2C master is enabled */
+        if (enable) {
+            if (read_register_8(pi, handle, REGMAP_USER_CTRL, &value) != RC_OK) break;
+            value &= (uint8_t)~USER_CTRL_I2C_MST_EN;
+            if (write_register_8(pi, handle, REGMAP_USER_CTRL, value) != RC_OK) break;
+        }
+        if (read_register_8(pi, handle, REGMAP_INT_PIN_CFG, &value) != RC_OK) break;
+        if (enable) value |= INT_PIN_CFG_I2C_BYPASS_EN;
+        else        value &= (uint8_t)~INT_PIN_CFG_I2C_BYPASS_EN;
+        if (write_register_8(pi, handle, REGMAP_INT_PIN_CFG, value) != RC_OK) break;
+
+        return RC_OK;
+    } while (0);
+    return RC_FAIL_SET;
+}
+
+int enable_aux_i2c_slave0(int pi, unsigned int handle, const aux_i2c_slave_cfg_t* cfg) {
+    assert(pi >= 0);
+    assert(cfg != NULL);
+
+    if ((cfg->addr & ~0x7Fu) != 0) return RC_INVALID_I2C_ADDR;
+    if (cfg->len == 0 || cfg->len > I2C_SLV_LEN_MAX) return RC_INVALID_ARGUMENT;
+
+    uint8_t value;
+
+    do {
+        /* The bypass mux must be open, otherwise the aux bus is wired straight to the host */
+        if (set_aux_i2c_bypass(pi, handle, false) != RC_OK) break;
+        if (write_register_8(pi, handle, REGMAP_I2C_MST_CTRL, I2C_MST_CLK_400_KHZ) != RC_OK) break;
+        if (write_register_8(pi, handle, REGMAP_I2C_SLV0_ADDR, (uint8_t)(I2C_SLV_RNW | cfg->addr)) != RC_OK) break;
+        if (write_register_8(pi, handle, REGMAP_I2C_SLV0_REG, cfg->reg) != RC_OK) break;
+        if (write_register_8(pi, handle, REGMAP_I2C_SLV0_CTRL, (uint8_t)(I2C_SLV_EN | cfg->len)) != RC_OK) break;
+        if (read_register_8(pi, handle, REGMAP_USER_CTRL, &value) != RC_OK) break;
+        value |= USER_CTRL_I2C_MST_EN;
+        if (write_register_8(pi, handle, REGMAP_USER_CTRL, value) != RC_OK) break;
+
+        return RC_OK;
+    } while (0);
+    return RC_FAIL_SET;
+}
+
+int disable_aux_i2c_master(int pi, unsigned int handle) {
+    assert(pi >= 0);
+
+    uint8_t value;
+
+    do {
+        if (write_register_8(pi, handle, REGMAP_I2C_SLV0_CTRL, 0x00) != RC_OK) break;
+        if (read_register_8(pi, handle, REGMAP_USER_CTRL, &value) != RC_OK) break;
+        value &= (uint8_t)~USER_CTRL_I2C_MST_EN;
+        if (write_register_8(pi, handle, REGMAP_USER_CTRL, value) != RC_OK) break;
+
+        return RC_OK;
+    } while (0);
+    return RC_FAIL_SET;
+}
+
+int get_accel_gyro_ext_data_real_fast(int pi, unsigned int handle, sensor_data_real_fast_t* accel, sensor_data_real_fast_t* gyro, ext_sens_data_t* ext) {
+    assert(pi >= 0);
+    assert(accel != NULL && gyro != NULL && ext != NULL);
+
+    if (ext->len == 0 || ext->len > EXT_SENS_DATA_MAX) return RC_INVALID_ARGUMENT;
+
+    /* ACCEL_XOUT_H .. GYRO_ZOUT_L is directly followed by EXT_SENS_DATA_00 */
+    uint8_t buf[14 + EXT_SENS_DATA_MAX];
+    unsigned int size = 14 + ext->len;
+    if (read_data_n(pi, handle, REGMAP_ACCEL_XOUT_H, buf, size) != (int)size) return RC_FAIL_GET;
+
+    convert_accel_gyro(buf, accel, gyro);
+    memcpy(ext->data, &buf[14], ext->len);
+    return RC_OK;
+}
+
+int enable_fifo(int pi, unsigned int handle, uint8_t sources) {
+    assert(pi >= 0);
+
+    uint8_t value;
+
+    do {
+        if (write_register_8(pi, handle, REGMAP_FIFO_EN, sources) != RC_OK) break;
+        if (read_register_8(pi, handle, REGMAP_INT_ENABLE, &value) != RC_OK) break;
+        value |= INT_FIFO_OFLOW;
+        if (write_register_8(pi, handle, REGMAP_INT_ENABLE, value) != RC_OK) break;
+        if (read_register_8(pi, handle, REGMAP_USER_CTRL, &value) != RC_OK) break;
+        value |= (USER_CTRL_FIFO_EN | USER_CTRL_FIFO_RESET);
+        if (write_register_8(pi, handle, REGMAP_USER_CTRL, value) != RC_OK) break;
+
+        return RC_OK;
+    } while (0);
+    return RC_FAIL_SET;
+}
+
+int disable_fifo(int pi, unsigned int handle) {
+    assert(pi >= 0);
+
+    uint8_t value;
+
+    do {
+        if (read_register_8(pi, handle, REGMAP_USER_CTRL, &value) != RC_OK) break;
+        value &= (uint8_t)~USER_CTRL_FIFO_EN;
+        if (write_register_8(pi, handle, REGMAP_USER_CTRL, value) != RC_OK) break;
+        if (write_register_8(pi, handle, REGMAP_FIFO_EN, 0x00) != RC_OK) break;
+
+        return RC_OK;
+    } while (0);
+    return RC_FAIL_SET;
+}
+
+int reset_fifo(int pi, unsigned int handle) {
+    assert(pi >= 0);
+
+    uint8_t value;
+
+    do {
+        if (read_register_8(pi, handle, REGMAP_USER_CTRL, &value) != RC_OK) break;
+        value |= USER_CTRL_FIFO_RESET;
+        if (write_register_8(pi, handle, REGMAP_USER_CTRL, value) != RC_OK) break;
+
+        return RC_OK;
+    } while (0);
+    return RC_FAIL_SET;
+}
+
+int get_fifo_count(int pi, unsigned int handle, uint16_t* value) {
+    assert(pi >= 0);
+    assert(value != NULL);
+
+    uint8_t buf[2];
+    if (read_data_n(pi, handle, REGMAP_FIFO_COUNTH, buf, sizeof(buf)) != (int)sizeof(buf)) return RC_FAIL_GET;
+    *value = (uint16_t)((buf[0] << 8) | buf[1]);
+    return RC_OK;
+}
+
+int get_int_status(int pi, unsigned int handle, uint8_t* value) {
+    assert(pi >= 0);
+    assert(value != NULL);
+
+    if (read_register_8(pi, handle, REGMAP_INT_STATUS, value) != RC_OK) return RC_FAIL_GET;
+    return RC_OK;
+}
+
+int read_fifo(int pi, unsigned int handle, uint8_t* buf, unsigned int n) {
+    assert(pi >= 0);
+    assert(buf != NULL);
+    assert(n > 0 && n <= FIFO_SIZE);
+
+    uint8_t reg = REGMAP_FIFO_R_W;
 
+    /* FIFO_R_W does not auto-increment, a burst read drains n bytes */
+    if (i2c_write_device(pi, handle, (char*)&reg, 1) != 0) return RC_FAIL_GET;
+    if (i2c_read_device(pi, handle, (char*)buf, n) != (int)n) return RC_FAIL_GET;
     return RC_OK;
 }
@@ -0,0 +1,276 @@
+#include "imu/vibration.h"
+
+#define VIB_PI 3.14159265358979323846
+
+static inline bool is_pow2(unsigned int v) {
+    return v != 0 && (v & (v - 1)) == 0;
+}
+
+static void fft_radix2(const vib_analyzer_t* an, float* re, float* im) {
+    const unsigned int n = an->cfg.fft_len;
+
+    for (unsigned int i = 0; i < n; ++i) {
+        unsigned int j = an->bitrev[i];
+        if (i < j) {
+            float t = re[i]; re[i] = re[j]; re[j] = t;
+            t = im[i]; im[i] = im[j]; im[j] = t;
+        }
+    }
+
+    for (unsigned int len = 2; len <= n; len <<= 1) {
+        const unsigned int half = len >> 1;
+        const unsigned int step = n / len;
+
+        for (unsigned int i = 0; i < n; i += len) {
+            for (unsigned int k = 0; k < half; ++k) {
+                const float wr = an->twiddle_re[k * step];
+                const float wi = an->twiddle_im[k * step];
+                const unsigned int a = i + k;
+                const unsigned int b = a + half;
+
+                const float tr = re[b] * wr - im[b] * wi;
+                const float ti = re[b] * wi + im[b] * wr;
+                re[b] = re[a] - tr;
+                im[b] = im[a] - ti;
+                re[a] += tr;
+                im[a] += ti;
+            }
+        }
+    }
+}
+
+static inline float ring_mean(const float* ring, unsigned int n) {
+    float sum = 0.0f;
+    for (unsigned int i = 0; i < n; ++i) sum += ring[i];
+    return sum / (float)n;
+}
+
+/* Copy the ring (oldest first) into dst, mean removed and windowed */
+static inline void load_segment(const vib_analyzer_t* an, const float* ring, float* dst) {
+    const unsigned int n = an->cfg.fft_len;
+    const unsigned int mask = n - 1;
+    const float mean = ring_mean(ring, n);
+
+    for (unsigned int j = 0; j < n; ++j) {
+        dst[j] = (ring[(an->head + j) & mask] - mean) * an->window[j];
+    }
+}
+
+static inline float one_sided(unsigned int k, unsigned int n) {
+    return (k == 0 || k == n / 2) ? 1.0f : 2.0f;
+}
+
+static void process_segment(vib_analyzer_t* an) {
+    const unsigned int n = an->cfg.fft_len;
+    const unsigned int mask = n - 1;
+    const unsigned int bins = n / 2 + 1;
+    float* re = an->work_re;
+    float* im = an->work_im;
+    float* psd_x = &an->psd_acc[VIB_AXIS_X * bins];
+    float* psd_y = &an->psd_acc[VIB_AXIS_Y * bins];
+    float* psd_z = &an->psd_acc[VIB_AXIS_Z * bins];
+
+    /* X and Y are real, so both fit into one complex transform: Z = X + iY */
+    load_segment(an, &an->ring[VIB_AXIS_X * n], re);
+    load_segment(an, &an->ring[VIB_AXIS_Y * n], im);
+    fft_radix2(an, re, im);
+
+    for (unsigned int k = 0; k < bins; ++k) {
+        const unsigned int m = (n - k) & mask;
+        const float sr = re[k] + re[m];
+        const float si = im[k] - im[m];
+        const float dr = re[k] - re[m];
+        const float di = im[k] + im[m];
+        const float scale = 0.25f * one_sided(k, n) * an->psd_scale;
+
+        psd_x[k] += (sr * sr + si * si) * scale;
+        psd_y[k] += (di * di + dr * dr) * scale;
+    }
+
+    load_segment(an, &an->ring[VIB_AXIS_Z * n], re);
+    memset(im, 0, n * sizeof(float));
+    fft_radix2(an, re, im);
+
+    for (unsigned int k = 0; k < bins; ++k) {
+        psd_z[k] += (re[k] * re[k] + im[k] * im[k]) * one_sided(k, n) * an->psd_scale;
+    }
+
+    an->n_segments++;
+}
+
+int vib_analyzer_init(vib_analyzer_t* an, const vib_config_t* cfg) {
+    assert(an != NULL);
+    assert(cfg != NULL);
+
+    memset(an, 0, sizeof(*an));
+
+    const unsigned int n = cfg->fft_len;
+    if (!is_pow2(n) || n < VIB_FFT_LEN_MIN || n > VIB_FFT_LEN_MAX) return RC_INVALID_ARGUMENT;
+    if (!(cfg->sample_rate_hz > 0.0f)) return RC_INVALID_ARGUMENT;
+    if (cfg->n_peaks > VIB_PEAKS_MAX) return RC_INVALID_ARGUMENT;
+    if (!(cfg->peak_rel_min >= 0.0f && cfg->peak_rel_min < 1.0f)) return RC_INVALID_ARGUMENT;
+
+    an->cfg = *cfg;
+    if (an->cfg.peak_rel_min == 0.0f) an->cfg.peak_rel_min = VIB_PEAK_REL_MIN;
+    while ((1u << an->log2_len) < n) an->log2_len++;
+
+    const unsigned int bins = n / 2 + 1;
+    const size_t n_floats = (size_t)n                /* window */
+                          + (size_t)n                /* twiddle_re + twiddle_im */
+                          + (size_t)VIB_AXES * n     /* ring */
+                          + (size_t)2 * n            /* work_re + work_im */
+                          + (size_t)VIB_AXES * bins; /* psd_acc */
+
+    float* block = malloc(n_floats * sizeof(float));
+    uint32_t* bitrev = malloc(n * sizeof(uint32_t));
+    if (block == NULL || bitrev == NULL) {
+        free(block);
+        free(bitrev);
+        return RC_RESOURCE_UNAVAILABLE;
+    }
+
+    an->window     = block;
+    an->twiddle_re = an->window + n;
+    an->twiddle_im = an->twiddle_re + n / 2;
+    an->ring       = an->twiddle_im + n / 2;
+    an->work_re    = an->ring + (size_t)VIB_AXES * n;
+    an->work_im    = an->work_re + n;
+    an->psd_acc    = an->work_im + n;
+    an->bitrev     = bitrev;
+
+    double window_power = 0.0;
+    for (unsigned int i = 0; i < n; ++i) {
+        double w = 0.5 - 0.5 * cos(2.0 * VIB_PI * (double)i / (double)n);
+        an->window[i] = (float)w;
+        window_power += w * w;
+    }
+    an->psd_scale = (float)(1.0 / ((double)cfg->sample_rate_hz * window_power));
+
+    for (unsigned int k = 0; k < n / 2; ++k) {
+        double phase = -2.0 * VIB_PI * (double)k / (double)n;
+        an->twiddle_re[k] = (float)cos(phase);
+        an->twiddle_im[k] = (float)sin(phase);
+    }
+
+    for (unsigned int i = 0; i < n; ++i) {
+        uint32_t r = 0;
+        for (unsigned int b = 0; b < an->log2_len; ++b) {
+            r |= ((i >> b) & 1u) << (an->log2_len - 1 - b);
+        }
+        an->bitrev[i] = r;
+    }
+
+    vib_analyzer_reset(an);
+    return RC_OK;
+}
+
+void vib_analyzer_free(vib_analyzer_t* an) {
+    assert(an != NULL);
+
+    free(an->window);
+    free(an->bitrev);
+    memset(an, 0, sizeof(*an));
+}
+
+void vib_analyzer_reset(vib_analyzer_t* an) {
+    assert(an != NULL);
+    assert(an->window != NULL);
+
+    const unsigned int bins = an->cfg.fft_len / 2 + 1;
+    memset(an->psd_acc, 0, (size_t)VIB_AXES * bins * sizeof(float));
+    an->head = 0;
+    an->filled = 0;
+    an->pending = 0;
+    an->n_segments = 0;
+}
+
+int vib_analyzer_push(vib_analyzer_t* an, const vec3f_t* samples, unsigned int n) {
+    assert(an != NULL);
+    assert(samples != NULL || n == 0);
+
+    const unsigned int len = an->cfg.fft_len;
+    const unsigned int mask = len - 1;
+    const unsigned int hop = len / 2;
+    float* ring_x = &an->ring[VIB_AXIS_X * len];
+    float* ring_y = &an->ring[VIB_AXIS_Y * len];
+    float* ring_z = &an->ring[VIB_AXIS_Z * len];
+    int segments = 0;
+
+    for (unsigned int i = 0; i < n; ++i) {
+        ring_x[an->head] = samples[i].x;
+        ring_y[an->head] = samples[i].y;
+        ring_z[an->head] = samples[i].z;
+        an->head = (an->head + 1) & mask;
+        if (an->filled < len) an->filled++;
+        an->pending++;
+
+        if (an->filled == len && an->pending >= hop) {
+            process_segment(an);
+            an->pending = 0;
+            segments++;
+        }
+    }
+    return segments;
+}
+
+int vib_analyzer_get_psd(const vib_analyzer_t* an, unsigned int axis, float* dst, unsigned int n) {
+    assert(an != NULL);
+    assert(dst != NULL);
+
+    const unsigned int bins = an->cfg.fft_len / 2 + 1;
+    if (axis >= VIB_AXES || n < bins) return RC_INVALID_ARGUMENT;
+    if (an->n_segments == 0) return RC_FAIL_GET;
+
+    const float* psd = &an->psd_acc[axis * bins];
+    const float inv = 1.0f / (float)an->n_segments;
+    for (unsigned int k = 0; k < bins; ++k) dst[k] = psd[k] * inv;
+    return RC_OK;
+}
+
+int vib_analyzer_get_result(const vib_analyzer_t* an, unsigned int axis, vib_axis_result_t* dst) {
+    assert(an != NULL);
+    assert(dst != NULL);
+
+    if (axis >= VIB_AXES) return RC_INVALID_ARGUMENT;
+    if (an->n_segments == 0) return RC_FAIL_GET;
+
+    const unsigned int bins = an->cfg.fft_len / 2 + 1;
+    const float* psd = &an->psd_acc[axis * bins];
+    const float inv = 1.0f / (float)an->n_segments;
+    const float df = an->cfg.sample_rate_hz / (float)an->cfg.fft_len;
+
+    /* DC is removed per segment, so start at bin 1 */
+    double power = 0.0;
+    for (unsigned int k = 1; k < bins; ++k) power += (double)psd[k];
+    dst->rms = (float)sqrt(power * (double)inv * (double)df);
+
+    /* Leakage and rounding leave tiny local maxima in the noise floor */
+    float psd_max = 0.0f;
+    for (unsigned int k = 1; k < bins; ++k) {
+        if (psd[k] > psd_max) psd_max = psd[k];
+    }
+    const float threshold = psd_max * an->cfg.peak_rel_min;
+
+    dst->n_peaks = 0;
+    for (unsigned int k = 1; k + 1 < bins; ++k) {
+        const float p = psd[k];
+        if (!(p > psd[k - 1] && p >= psd[k + 1])) continue;
+        if (p < threshold || p <= 0.0f) continue;
+
+        unsigned int pos = dst->n_peaks;
+        while (pos > 0 && dst->peaks[pos - 1].psd < p * inv) pos--;
+        if (pos >= an->cfg.n_peaks) continue;
+
+        unsigned int last = (dst->n_peaks < an->cfg.n_peaks) ? dst->n_peaks : an->cfg.n_peaks - 1;
+        for (unsigned int i = last; i > pos; --i) dst->peaks[i] = dst->peaks[i - 1];
+
+        /* Parabolic interpolation between the neighbouring bins */
+        const float denom = psd[k - 1] - 2.0f * p + psd[k + 1];
+        const float delta = (denom != 0.0f) ? 0.5f * (psd[k - 1] - psd[k + 1]) / denom : 0.0f;
+
+        dst->peaks[pos].freq_hz = ((float)k + delta) * df;
+        dst->peaks[pos].psd = p * inv;
+        if (dst->n_peaks < an->cfg.n_peaks) dst->n_peaks++;
+    }
+    return RC_OK;
+}
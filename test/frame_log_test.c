@@ -0,0 +1,67 @@
+#include "imu/frame_log.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/* Offline round trip of the frame file writer */
+
+#define TEST_PATH "frame_log_test.bin"
+#define N_FRAMES  1000
+
+int main(void) {
+    static vec3i_t accel[N_FRAMES], gyro[N_FRAMES];
+    for (int i = 0; i < N_FRAMES; ++i) {
+        accel[i] = (vec3i_t){ (int16_t)i, (int16_t)-i, 16384 };
+        gyro[i]  = (vec3i_t){ (int16_t)(3 * i), 0, (int16_t)-32768 };
+    }
+
+    frame_log_t log;
+    if (frame_log_open(&log, TEST_PATH, 100.0f, ACCEL_PER_DIGIT_2_G, GYRO_PER_DIGIT_250_DPS) != RC_OK) {
+        printf("FAIL open \n");
+        return 1;
+    }
+    /* Uneven chunks, as delivered by successive batches */
+    if (frame_log_append(&log, accel, gyro, 85) != RC_OK ||
+        frame_log_append(&log, &accel[85], &gyro[85], N_FRAMES - 85) != RC_OK ||
+        frame_log_close(&log) != RC_OK) {
+        printf("FAIL write \n");
+        return 1;
+    }
+
+    FILE* fp = fopen(TEST_PATH, "rb");
+    if (fp == NULL) {
+        printf("FAIL reopen \n");
+        return 1;
+    }
+
+    int failures = 0;
+    frame_log_header_t hdr;
+    if (fread(&hdr, sizeof(hdr), 1, fp) != 1 || hdr.magic != FRAME_LOG_MAGIC || hdr.version != FRAME_LOG_VERSION ||
+        hdr.frame_size != sizeof(imu_frame_t) || hdr.sample_rate_hz != 100.0f ||
+        hdr.accel_per_digit != ACCEL_PER_DIGIT_2_G || hdr.gyro_per_digit != GYRO_PER_DIGIT_250_DPS) {
+        printf("FAIL header \n");
+        failures++;
+    }
+
+    imu_frame_t f;
+    int n = 0;
+    while (fread(&f, sizeof(f), 1, fp) == 1) {
+        if (memcmp(&f.accel, &accel[n], sizeof(vec3i_t)) != 0 || memcmp(&f.gyro, &gyro[n], sizeof(vec3i_t)) != 0) {
+            printf("FAIL frame %d \n", n);
+            failures++;
+            break;
+        }
+        n++;
+    }
+    if (n != N_FRAMES) {
+        printf("FAIL %d frames, expected %d \n", n, N_FRAMES);
+        failures++;
+    }
+
+    (void)fclose(fp);
+    (void)remove(TEST_PATH);
+
+    if (failures != 0) return 1;
+    printf("frame_log_test: OK \n");
+    return 0;
+}
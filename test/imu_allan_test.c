@@ -0,0 +1,143 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "imu/frame_log.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Offline check of imu_allan on synthetic white noise: thread independence and noise density */
+
+#define TEST_PATH    "imu_allan_test.bin"
+#define TEST_PI      3.14159265358979323846
+#define SAMPLE_RATE  100.0
+#define N_FRAMES     (1u << 17)
+#define CHUNK        1024
+#define SIGMA_RAW    100.0  /* white noise std of the noisy axes [digit] */
+#define OUTPUT_MAX   65536
+
+static int failures = 0;
+
+static void expect_true(const char* what, bool cond) {
+    if (cond) return;
+    printf("FAIL %s \n", what);
+    failures++;
+}
+
+/* xorshift64 + Box-Muller, fixed seed so the file is the same on every run */
+static uint64_t rng_state = 0x9E3779B97F4A7C15ull;
+
+static double uniform(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return ((double)(rng_state >> 11) + 0.5) / 9007199254740992.0;
+}
+
+static int16_t noise_raw(void) {
+    const double g = sqrt(-2.0 * log(uniform())) * cos(2.0 * TEST_PI * uniform());
+    return (int16_t)lround(SIGMA_RAW * g);
+}
+
+static int write_file(void) {
+    static vec3i_t accel[CHUNK], gyro[CHUNK];
+    frame_log_t log;
+
+    if (frame_log_open(&log, TEST_PATH, (float)SAMPLE_RATE, ACCEL_PER_DIGIT_2_G, GYRO_PER_DIGIT_250_DPS) != RC_OK) return -1;
+    for (unsigned int base = 0; base < N_FRAMES; base += CHUNK) {
+        for (unsigned int i = 0; i < CHUNK; ++i) {
+            /* ax is constant, it has no bias instability */
+            accel[i] = (vec3i_t){ 16384, noise_raw(), noise_raw() };
+            gyro[i]  = (vec3i_t){ noise_raw(), noise_raw(), noise_raw() };
+        }
+        if (frame_log_append(&log, accel, gyro, CHUNK) != RC_OK) {
+            (void)frame_log_close(&log);
+            return -1;
+        }
+    }
+    return frame_log_close(&log);
+}
+
+/* Run the tool and keep its output without the first line, which names the thread count */
+static int run(const char* tool, unsigned int threads, char* out, size_t size) {
+    char cmd[1024];
+    snprintf(cmd, sizeof(cmd), "\"%s\" -v -b 10 -j %u %s", tool, threads, TEST_PATH);
+
+    FILE* p = popen(cmd, "r");
+    if (p == NULL) return -1;
+
+    char line[256];
+    size_t len = 0;
+    bool first = true;
+    out[0] = '\0';
+    while (fgets(line, sizeof(line), p) != NULL) {
+        if (first) { first = false; continue; }
+        const size_t n = strlen(line);
+        if (len + n >= size) break;
+        memcpy(&out[len], line, n + 1);
+        len += n;
+    }
+    return (pclose(p) == 0 && len > 0) ? 0 : -1;
+}
+
+/* Find the summary row of an axis */
+static const char* axis_row(const char* out, const char* axis) {
+    char key[16];
+    snprintf(key, sizeof(key), "\n  %-4s ", axis);
+    const char* row = strstr(out, key);
+    return (row != NULL) ? row + 1 : NULL;
+}
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        printf("usage: %s path/to/imu_allan \n", argv[0]);
+        return 1;
+    }
+    if (write_file() != RC_OK) {
+        printf("FAIL write \n");
+        return 1;
+    }
+
+    static char out_1[OUTPUT_MAX], out_n[OUTPUT_MAX];
+    expect_true("run -j 1", run(argv[1], 1, out_1, sizeof(out_1)) == 0);
+
+    /* Chunk boundaries move with the thread count, the result must not */
+    const unsigned int threads[] = { 2, 3, 8 };
+    for (unsigned int t = 0; t < sizeof(threads) / sizeof(threads[0]); ++t) {
+        char what[64];
+        snprintf(what, sizeof(what), "run -j %u", threads[t]);
+        expect_true(what, run(argv[1], threads[t], out_n, sizeof(out_n)) == 0);
+        snprintf(what, sizeof(what), "-j %u output equals -j 1", threads[t]);
+        expect_true(what, strcmp(out_1, out_n) == 0);
+    }
+
+    /* White noise: noise density = sigma / sqrt(fs) */
+    const char* const noisy[] = { "ay", "az", "gx", "gy", "gz" };
+    for (unsigned int a = 0; a < sizeof(noisy) / sizeof(noisy[0]); ++a) {
+        const bool gyro = (noisy[a][0] == 'g');
+        const double expected = SIGMA_RAW * (gyro ? GYRO_PER_DIGIT_250_DPS : ACCEL_PER_DIGIT_2_G) / sqrt(SAMPLE_RATE);
+
+        const char* row = axis_row(out_1, noisy[a]);
+        char name[8];
+        double mean, std, noise;
+        bool ok = (row != NULL && sscanf(row, "%7s %lf %lf %lf", name, &mean, &std, &noise) == 4);
+        if (ok && fabs(noise - expected) > 0.1 * expected) {
+            printf("FAIL noise %s: %.4e, expected %.4e (+/- 10%%) \n", noisy[a], noise, expected);
+            failures++;
+        }
+        expect_true(noisy[a], ok);
+    }
+
+    const char* row = axis_row(out_1, "ax");
+    expect_true("constant ax bias instability n/a", row != NULL && strstr(row, "n/a") != NULL && strstr(row, "n/a") < strchr(row, '['));
+
+    (void)remove(TEST_PATH);
+
+    if (failures != 0) {
+        printf("%s", out_1);
+        return 1;
+    }
+    printf("imu_allan_test: OK \n");
+    return 0;
+}
@@ -0,0 +1,38 @@
+#include "imu/mpu6050.hpp"
+
+#include <array>
+#include <cstdio>
+#include <unistd.h>
+
+using imu_session = imu::session<ACCEL_8_G, GYRO_500_DPS>;
+
+static_assert(imu_session::accel_scale == ACCEL_PER_DIGIT_8_G);
+static_assert(imu_session::gyro_scale == GYRO_PER_DIGIT_500_DPS);
+static_assert(imu::accel_per_digit(ACCEL_2_G) == ACCEL_PER_DIGIT_2_G);
+static_assert(imu::gyro_per_digit(GYRO_2000_DPS) == GYRO_PER_DIGIT_2000_DPS);
+
+int main() {
+    try {
+        imu::pigpiod pi(LOCALHOST, "8888");
+        imu_session s(pi);
+
+        if (s.set_dlpf(DLPF_CFG_3) != RC_OK) printf("Failed to set DLPF \n");
+        if (s.set_sample_rate_div(4) != RC_OK) printf("Failed to set sample rate \n");
+
+        if (s.enable_fifo() != RC_OK) printf("Failed to enable FIFO \n");
+        usleep(50000);
+
+        std::array<imu::sample, 5> buf;
+        int n = s.read(buf);
+        if (n < 0) printf("Failed to read FIFO [status %d] \n", n);
+        for (int i = 0; i < n; ++i) {
+            printf("Accel: x=%.2f, y=%.2f, z=%.2f \n", buf[i].accel.x, buf[i].accel.y, buf[i].accel.z);
+            printf("Gyro: x=%.2f, y=%.2f, z=%.2f \n", buf[i].gyro.x, buf[i].gyro.y, buf[i].gyro.z);
+        }
+    }
+    catch (const imu::error& e) {
+        printf("%s [status %d] \n", e.what(), e.code());
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,118 @@
+#include "imu/vibration.h"
+
+#include <stdio.h>
+
+/* Offline check of the Welch PSD, RMS and peak detection with known sines */
+
+#define TEST_PI      3.14159265358979323846
+#define SAMPLE_RATE  1000.0f
+#define FFT_LEN      1024
+#define N_SAMPLES    20000
+#define CHUNK        100
+
+static int failures = 0;
+
+static void expect_near(const char* what, double actual, double expected, double tol) {
+    if (fabs(actual - expected) <= tol) return;
+    printf("FAIL %s: %.6f, expected %.6f (+/- %.6f) \n", what, actual, expected, tol);
+    failures++;
+}
+
+static void expect_true(const char* what, bool cond) {
+    if (cond) return;
+    printf("FAIL %s \n", what);
+    failures++;
+}
+
+static double sine(double amp, double freq, unsigned int i) {
+    return amp * sin(2.0 * TEST_PI * freq * (double)i / (double)SAMPLE_RATE);
+}
+
+int main(void) {
+    vib_analyzer_t an;
+    vib_config_t cfg = { FFT_LEN, SAMPLE_RATE, 3, 0.0f };
+
+    expect_true("init", vib_analyzer_init(&an, &cfg) == RC_OK);
+
+    vib_axis_result_t r;
+    expect_true("no result before the first segment", vib_analyzer_get_result(&an, VIB_AXIS_X, &r) == RC_FAIL_GET);
+
+    /* X: 1 g offset + 1 g at 50 Hz, Y: 0.5 g at 123.3 Hz + 0.1 g at 300 Hz, Z: 0.2 g at 200 Hz */
+    vec3f_t buf[CHUNK];
+    int segments = 0;
+    for (unsigned int base = 0; base < N_SAMPLES; base += CHUNK) {
+        for (unsigned int i = 0; i < CHUNK; ++i) {
+            buf[i].x = (float)(1.0 + sine(1.0, 50.0, base + i));
+            buf[i].y = (float)(sine(0.5, 123.3, base + i) + sine(0.1, 300.0, base + i));
+            buf[i].z = (float)sine(0.2, 200.0, base + i);
+        }
+        segments += vib_analyzer_push(&an, buf, CHUNK);
+    }
+    expect_true("segment count", segments == (int)an.n_segments && segments == (N_SAMPLES - FFT_LEN) / (FFT_LEN / 2) + 1);
+
+    const double df = SAMPLE_RATE / FFT_LEN;
+
+    expect_true("result x", vib_analyzer_get_result(&an, VIB_AXIS_X, &r) == RC_OK);
+    expect_near("rms x", r.rms, 1.0 / sqrt(2.0), 0.01);
+    expect_true("peaks x", r.n_peaks == 1);
+    expect_near("peak x", r.peaks[0].freq_hz, 50.0, df / 4);
+
+    expect_true("result y", vib_analyzer_get_result(&an, VIB_AXIS_Y, &r) == RC_OK);
+    expect_near("rms y", r.rms, sqrt(0.5 * 0.5 / 2.0 + 0.1 * 0.1 / 2.0), 0.01);
+    expect_true("peaks y", r.n_peaks == 2);
+    expect_near("peak y 0", r.peaks[0].freq_hz, 123.3, df / 4);
+    expect_near("peak y 1", r.peaks[1].freq_hz, 300.0, df / 4);
+
+    expect_true("result z", vib_analyzer_get_result(&an, VIB_AXIS_Z, &r) == RC_OK);
+    expect_near("rms z", r.rms, 0.2 / sqrt(2.0), 0.005);
+    expect_true("peaks z", r.n_peaks == 1);
+    expect_near("peak z", r.peaks[0].freq_hz, 200.0, df / 4);
+
+    /* X and Y share one transform, neither may leak into the other */
+    float psd[FFT_LEN / 2 + 1];
+    expect_true("psd x", vib_analyzer_get_psd(&an, VIB_AXIS_X, psd, FFT_LEN / 2 + 1) == RC_OK);
+    expect_true("no y leakage into x", psd[(unsigned int)(123.3 / df + 0.5)] < 1e-6f);
+
+    vib_analyzer_reset(&an);
+    expect_true("no result after reset", vib_analyzer_get_result(&an, VIB_AXIS_X, &r) == RC_FAIL_GET);
+    vib_analyzer_free(&an);
+
+    /* X: 1 g at 50 Hz + 0.02 g at 200 Hz + 0.005 g at 317 Hz, the weakest peak is 46 dB below the maximum */
+    cfg.n_peaks = 4;
+    expect_true("init weak", vib_analyzer_init(&an, &cfg) == RC_OK);
+    for (unsigned int base = 0; base < N_SAMPLES; base += CHUNK) {
+        for (unsigned int i = 0; i < CHUNK; ++i) {
+            buf[i].x = (float)(sine(1.0, 50.0, base + i) + sine(0.02, 200.0, base + i) + sine(0.005, 317.0, base + i));
+            buf[i].y = 0.0f;
+            buf[i].z = 0.0f;
+        }
+        (void)vib_analyzer_push(&an, buf, CHUNK);
+    }
+    expect_true("result weak", vib_analyzer_get_result(&an, VIB_AXIS_X, &r) == RC_OK);
+    expect_true("peaks weak", r.n_peaks == 3);
+    expect_near("peak weak 0", r.peaks[0].freq_hz, 50.0, df / 4);
+    expect_near("peak weak 1", r.peaks[1].freq_hz, 200.0, df / 4);
+    expect_near("peak weak 2", r.peaks[2].freq_hz, 317.0, df / 4);
+    expect_true("no peaks on a zero axis", vib_analyzer_get_result(&an, VIB_AXIS_Y, &r) == RC_OK && r.n_peaks == 0);
+    vib_analyzer_free(&an);
+
+    /* A coarser floor hides the weak peaks */
+    cfg.peak_rel_min = 1e-3f;
+    expect_true("init floor", vib_analyzer_init(&an, &cfg) == RC_OK);
+    for (unsigned int base = 0; base < N_SAMPLES; base += CHUNK) {
+        for (unsigned int i = 0; i < CHUNK; ++i) {
+            buf[i].x = (float)(sine(1.0, 50.0, base + i) + sine(0.02, 200.0, base + i) + sine(0.005, 317.0, base + i));
+        }
+        (void)vib_analyzer_push(&an, buf, CHUNK);
+    }
+    expect_true("result floor", vib_analyzer_get_result(&an, VIB_AXIS_X, &r) == RC_OK);
+    expect_true("peaks floor", r.n_peaks == 1);
+    vib_analyzer_free(&an);
+
+    cfg.peak_rel_min = 1.0f;
+    expect_true("invalid floor", vib_analyzer_init(&an, &cfg) == RC_INVALID_ARGUMENT);
+
+    if (failures != 0) return 1;
+    printf("vibration_test: OK \n");
+    return 0;
+}
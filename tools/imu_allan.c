@@ -0,0 +1,357 @@
+#define _POSIX_C_SOURCE 200809L
+#define _FILE_OFFSET_BITS 64
+
+/**
+ * @file imu_allan.c
+ * @brief Per-axis noise characterization (Allan deviation, noise density, bias instability) of frame files
+ *
+ * Each file is split into contiguous ranges aligned to 2^block_log2 frames and
+ * processed by one thread per range. A thread keeps octave cluster averages
+ * (tau = 2^j samples, j < block_log2) in O(levels) memory and emits one mean
+ * per block; longer taus are computed from the block means after the join.
+ * Allan variance is the non-overlapping estimator.
+ *
+ * usage: imu_allan [-j threads] [-b block_log2] [-v] file...
+*/
+
+#include "imu/frame_log.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define AXES               6
+#define LEVELS_MAX         48
+#define BLOCK_LOG2_DEFAULT 16
+#define BLOCK_LOG2_MIN     4
+#define BLOCK_LOG2_MAX     24
+#define READ_FRAMES        4096
+#define MIN_CLUSTERS       9    /* clusters required before a tau is used for the estimates */
+
+static const char* const AXIS_NAME[AXES] = { "ax", "ay", "az", "gx", "gy", "gz" };
+static const char* const AXIS_UNIT[AXES] = { "g", "g", "g", "dps", "dps", "dps" };
+
+typedef struct {
+    double first;
+    double last;
+    double sumsq;       /* sum of squared differences of consecutive cluster averages */
+    uint64_t count;     /* number of cluster averages */
+} level_stat_t;
+
+typedef struct {
+    unsigned int n_levels;
+    level_stat_t stat[LEVELS_MAX];
+    double pending[LEVELS_MAX];
+    bool has_pending[LEVELS_MAX];
+} octave_t;
+
+typedef struct {
+    uint64_t n;
+    double mean;
+    double m2;
+} welford_t;
+
+typedef struct {
+    int fd;
+    const frame_log_header_t* hdr;
+    uint64_t begin;          /* first frame */
+    uint64_t end;            /* one past the last frame */
+    unsigned int block_log2;
+    double* block_means;     /* shared, AXES values per block */
+    octave_t oct[AXES];
+    welford_t stats[AXES];
+    int err;
+} worker_t;
+
+/* Returns true and the average of 2^n_levels samples when a top level cluster completes */
+static inline bool octave_push(octave_t* o, double v, double* top) {
+    for (unsigned int j = 0; j < o->n_levels; ++j) {
+        level_stat_t* s = &o->stat[j];
+        if (s->count == 0) s->first = v;
+        else {
+            double d = v - s->last;
+            s->sumsq += d * d;
+        }
+        s->last = v;
+        s->count++;
+
+        if (!o->has_pending[j]) {
+            o->pending[j] = v;
+            o->has_pending[j] = true;
+            return false;
+        }
+        v = 0.5 * (o->pending[j] + v);
+        o->has_pending[j] = false;
+    }
+    *top = v;
+    return true;
+}
+
+/* Append the stats of the range directly following dst */
+static void level_merge(level_stat_t* dst, const level_stat_t* src) {
+    if (src->count == 0) return;
+    if (dst->count == 0) {
+        *dst = *src;
+        return;
+    }
+    double d = src->first - dst->last;
+    dst->sumsq += src->sumsq + d * d;
+    dst->count += src->count;
+    dst->last = src->last;
+}
+
+static inline void welford_push(welford_t* w, double v) {
+    w->n++;
+    double d = v - w->mean;
+    w->mean += d / (double)w->n;
+    w->m2 += d * (v - w->mean);
+}
+
+static void welford_merge(welford_t* dst, const welford_t* src) {
+    if (src->n == 0) return;
+    uint64_t n = dst->n + src->n;
+    double d = src->mean - dst->mean;
+    dst->mean += d * (double)src->n / (double)n;
+    dst->m2 += src->m2 + d * d * (double)dst->n * (double)src->n / (double)n;
+    dst->n = n;
+}
+
+static void* worker_run(void* arg) {
+    worker_t* w = arg;
+    const size_t frame_size = w->hdr->frame_size;
+    const double apd = (double)w->hdr->accel_per_digit;
+    const double gpd = (double)w->hdr->gyro_per_digit;
+    uint64_t block = w->begin >> w->block_log2;
+
+    uint8_t* buf = malloc(READ_FRAMES * frame_size);
+    if (buf == NULL) {
+        w->err = ENOMEM;
+        return NULL;
+    }
+
+    for (uint64_t pos = w->begin; pos < w->end; ) {
+        uint64_t n = w->end - pos;
+        if (n > READ_FRAMES) n = READ_FRAMES;
+
+        size_t want = (size_t)n * frame_size;
+        off_t off = (off_t)(sizeof(frame_log_header_t) + pos * frame_size);
+        size_t got = 0;
+        while (got < want) {
+            ssize_t r = pread(w->fd, buf + got, want - got, off + (off_t)got);
+            if (r <= 0) {
+                w->err = (r == 0) ? EIO : errno;
+                free(buf);
+                return NULL;
+            }
+            got += (size_t)r;
+        }
+
+        for (uint64_t i = 0; i < n; ++i) {
+            imu_frame_t f;
+            memcpy(&f, buf + i * frame_size, sizeof(f));
+
+            const double v[AXES] = {
+                f.accel.x * apd, f.accel.y * apd, f.accel.z * apd,
+                f.gyro.x * gpd,  f.gyro.y * gpd,  f.gyro.z * gpd,
+            };
+            bool block_done = false;
+            for (unsigned int a = 0; a < AXES; ++a) {
+                double top;
+                welford_push(&w->stats[a], v[a]);
+                if (octave_push(&w->oct[a], v[a], &top)) {
+                    w->block_means[block * AXES + a] = top;
+                    block_done = true;
+                }
+            }
+            if (block_done) block++;
+        }
+        pos += n;
+    }
+
+    free(buf);
+    return NULL;
+}
+
+static void print_axis(unsigned int a, const welford_t* st, const level_stat_t* lv, unsigned int n_levels, double fs, bool verbose) {
+    double best_tau_dist = INFINITY, noise_density = NAN;
+    double adev_min = INFINITY, tau_min = NAN;
+    unsigned int j_min = 0, j_last = 0;
+
+    for (unsigned int j = 0; j < n_levels; ++j) {
+        if (lv[j].count < MIN_CLUSTERS) continue;
+
+        const double tau = ldexp(1.0, (int)j) / fs;
+        const double adev = sqrt(lv[j].sumsq / (2.0 * (double)(lv[j].count - 1)));
+
+        /* White noise: adev(tau) = N / sqrt(tau), read N near tau = 1 s */
+        const double dist = fabs(log(tau));
+        if (dist < best_tau_dist) {
+            best_tau_dist = dist;
+            noise_density = adev * sqrt(tau);
+        }
+        if (adev < adev_min) {
+            adev_min = adev;
+            tau_min = tau;
+            j_min = j;
+        }
+        j_last = j;
+    }
+
+    const double std = (st->n > 1) ? sqrt(st->m2 / (double)(st->n - 1)) : NAN;
+    printf("  %-4s %14.6e %12.4e %14.4e", AXIS_NAME[a], st->mean, std, noise_density);
+
+    /* Still falling at the longest usable tau: no flat region, the minimum is only the noise floor.
+     * A constant axis (adev 0 at every tau) has no bias instability either. */
+    if (isinf(adev_min) || adev_min == 0.0 || j_min == j_last) printf(" %14s %10s", "n/a", "n/a");
+    else printf(" %14.4e %10.3f", adev_min / 0.664, tau_min);
+    printf("  [%s]\n", AXIS_UNIT[a]);
+
+    if (!verbose) return;
+    for (unsigned int j = 0; j < n_levels; ++j) {
+        if (lv[j].count < 2) continue;
+        printf("        tau %12.4f s  adev %12.4e  clusters %llu\n",
+               ldexp(1.0, (int)j) / fs, sqrt(lv[j].sumsq / (2.0 * (double)(lv[j].count - 1))),
+               (unsigned long long)lv[j].count);
+    }
+}
+
+static int analyze_file(const char* path, unsigned int n_threads, unsigned int block_log2, bool verbose) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "%s: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    frame_log_header_t hdr;
+    struct stat sb;
+    if (pread(fd, &hdr, sizeof(hdr), 0) != (ssize_t)sizeof(hdr) || fstat(fd, &sb) != 0 ||
+        hdr.magic != FRAME_LOG_MAGIC || hdr.version != FRAME_LOG_VERSION ||
+        hdr.frame_size < sizeof(imu_frame_t) || !(hdr.sample_rate_hz > 0.0f)) {
+        fprintf(stderr, "%s: not a frame file\n", path);
+        close(fd);
+        return -1;
+    }
+
+    const uint64_t n_frames = ((uint64_t)sb.st_size - sizeof(hdr)) / hdr.frame_size;
+    const uint64_t n_blocks = n_frames >> block_log2;
+
+    if (n_threads > n_blocks) n_threads = (n_blocks > 0) ? (unsigned int)n_blocks : 1;
+
+    worker_t* workers = calloc(n_threads, sizeof(worker_t));
+    pthread_t* tids = calloc(n_threads, sizeof(pthread_t));
+    double* block_means = malloc((size_t)(n_blocks > 0 ? n_blocks : 1) * AXES * sizeof(double));
+    if (workers == NULL || tids == NULL || block_means == NULL) {
+        fprintf(stderr, "%s: out of memory\n", path);
+        free(workers); free(tids); free(block_means);
+        close(fd);
+        return -1;
+    }
+
+    /* Contiguous block ranges, the tail that does not fill a block goes to the last thread */
+    uint64_t next = 0;
+    unsigned int started = 0;
+    for (unsigned int t = 0; t < n_threads; ++t) {
+        worker_t* w = &workers[t];
+        uint64_t blocks = n_blocks / n_threads + ((t < n_blocks % n_threads) ? 1 : 0);
+
+        w->fd = fd;
+        w->hdr = &hdr;
+        w->begin = next;
+        w->end = (t + 1 == n_threads) ? n_frames : next + (blocks << block_log2);
+        w->block_log2 = block_log2;
+        w->block_means = block_means;
+        for (unsigned int a = 0; a < AXES; ++a) w->oct[a].n_levels = block_log2;
+        next = w->end;
+
+        if (pthread_create(&tids[t], NULL, worker_run, w) != 0) {
+            w->err = EAGAIN;
+            break;
+        }
+        started++;
+    }
+
+    int rc = 0;
+    for (unsigned int t = 0; t < started; ++t) pthread_join(tids[t], NULL);
+    for (unsigned int t = 0; t < n_threads; ++t) {
+        if (workers[t].err != 0) {
+            fprintf(stderr, "%s: %s\n", path, strerror(workers[t].err));
+            rc = -1;
+            break;
+        }
+    }
+
+    if (rc == 0) {
+        const double fs = (double)hdr.sample_rate_hz;
+        printf("%s: %llu frames, %.1f Hz, %.2f h, %u threads\n",
+               path, (unsigned long long)n_frames, fs, (double)n_frames / fs / 3600.0, n_threads);
+        printf("  %-4s %14s %12s %14s %14s %10s\n",
+               "axis", "mean", "std", "noise/rtHz", "bias_instab", "tau_bi[s]");
+
+        for (unsigned int a = 0; a < AXES; ++a) {
+            welford_t st = {0};
+            level_stat_t lv[LEVELS_MAX];
+            memset(lv, 0, sizeof(lv));
+
+            for (unsigned int t = 0; t < n_threads; ++t) {
+                welford_merge(&st, &workers[t].stats[a]);
+                for (unsigned int j = 0; j < block_log2; ++j) level_merge(&lv[j], &workers[t].oct[a].stat[j]);
+            }
+
+            /* Taus of a block and longer come from the block means */
+            octave_t tail;
+            memset(&tail, 0, sizeof(tail));
+            tail.n_levels = LEVELS_MAX - block_log2;
+            for (uint64_t b = 0; b < n_blocks; ++b) {
+                double top;
+                (void)octave_push(&tail, block_means[b * AXES + a], &top);
+            }
+            memcpy(&lv[block_log2], tail.stat, tail.n_levels * sizeof(level_stat_t));
+
+            print_axis(a, &st, lv, LEVELS_MAX, fs, verbose);
+        }
+    }
+
+    free(workers);
+    free(tids);
+    free(block_means);
+    close(fd);
+    return rc;
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr, "usage: %s [-j threads] [-b block_log2 (%d-%d)] [-v] file...\n",
+            prog, BLOCK_LOG2_MIN, BLOCK_LOG2_MAX);
+}
+
+int main(int argc, char** argv) {
+    long n_threads = sysconf(_SC_NPROCESSORS_ONLN);
+    long block_log2 = BLOCK_LOG2_DEFAULT;
+    bool verbose = false;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "j:b:v")) != -1) {
+        switch (opt) {
+            case 'j': n_threads = strtol(optarg, NULL, 10); break;
+            case 'b': block_log2 = strtol(optarg, NULL, 10); break;
+            case 'v': verbose = true; break;
+            default:  usage(argv[0]); return 1;
+        }
+    }
+    if (optind >= argc || n_threads < 1 || block_log2 < BLOCK_LOG2_MIN || block_log2 > BLOCK_LOG2_MAX) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    int rc = 0;
+    for (int i = optind; i < argc; ++i) {
+        if (analyze_file(argv[i], (unsigned int)n_threads, (unsigned int)block_log2, verbose) != 0) rc = 1;
+    }
+    return rc;
+}